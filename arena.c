@@ -0,0 +1,129 @@
+/*
+ * arena.c
+ *
+ *  Created on: 19.10.2026
+ */
+
+#define _GNU_SOURCE
+
+#include "arena.h"
+
+/* required for SIZE_MAX */
+#include <stdint.h>
+/* required for posix_memalign, free */
+#include <stdlib.h>
+/* required for memset */
+#include <string.h>
+/* required for mmap, madvise, munmap */
+#include <sys/mman.h>
+
+/** first byte of the arena, NULL if it is not open */
+static char* arenaBase = NULL;
+/** count of bytes reserved for the arena */
+static size_t arenaLength = 0;
+/** count of bytes handed out */
+static size_t arenaUsed = 0;
+
+int arena_open(size_t length, bool hugePages)
+{
+    if (NULL != arenaBase || 0 == length)
+    {
+        return 1;
+    }
+    /* the pages are never reused, so they are still zero-filled when handed out */
+    void* mapping = mmap(NULL, length, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (MAP_FAILED == mapping)
+    {
+        return 2;
+    }
+#ifdef MADV_HUGEPAGE
+    if (hugePages)
+    {
+        /* only a hint, without transparent huge pages the arena uses small pages */
+        madvise(mapping, length, MADV_HUGEPAGE);
+    }
+#else
+    (void)hugePages;
+#endif
+    arenaBase = mapping;
+    arenaLength = length;
+    arenaUsed = 0;
+    return 0;
+}
+
+void* arena_calloc(size_t count, size_t size)
+{
+    if (0 != size && count > SIZE_MAX / size)
+    {
+        return NULL;
+    }
+    return arena_calloc_aligned(count * size, ARENA_ALIGNMENT);
+}
+
+void* arena_calloc_aligned(size_t length, size_t alignment)
+{
+    if (alignment < ARENA_ALIGNMENT)
+    {
+        alignment = ARENA_ALIGNMENT;
+    }
+    /* lengths are rounded up, so that the next allocation starts aligned in the common case */
+    length = (length + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1);
+    if (NULL != arenaBase && 0 < length && length <= arenaLength)
+    {
+        size_t used = __atomic_load_n(&arenaUsed, __ATOMIC_RELAXED);
+        size_t offset = 0;
+        do
+        {
+            offset = (used + alignment - 1) & ~(alignment - 1);
+            if (offset + length > arenaLength)
+            {
+                break;
+            }
+        } while (!__atomic_compare_exchange_n(&arenaUsed, &used, offset + length, true,
+                                              __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+        if (offset + length <= arenaLength)
+        {
+            return arenaBase + offset;
+        }
+    }
+    void* memory = NULL;
+    if (posix_memalign(&memory, alignment, (0 < length) ? length : alignment))
+    {
+        return NULL;
+    }
+    memset(memory, 0, (0 < length) ? length : alignment);
+    return memory;
+}
+
+bool arena_contains(const void* ptr)
+{
+    return NULL != arenaBase && (const char*)ptr >= arenaBase &&
+           (const char*)ptr < arenaBase + arenaLength;
+}
+
+void arena_free(void* ptr)
+{
+    if (!arena_contains(ptr))
+    {
+        free(ptr);
+    }
+}
+
+size_t arena_in_use(void)
+{
+    size_t used = __atomic_load_n(&arenaUsed, __ATOMIC_RELAXED);
+    return (used < arenaLength) ? used : arenaLength;
+}
+
+void arena_close(void)
+{
+    if (NULL == arenaBase)
+    {
+        return;
+    }
+    munmap(arenaBase, arenaLength);
+    arenaBase = NULL;
+    arenaLength = 0;
+    arenaUsed = 0;
+}
@@ -0,0 +1,67 @@
+/*
+ * arena.h
+ *
+ *  Created on: 19.10.2026
+ */
+
+#ifndef ARENA_H_
+#define ARENA_H_
+
+/* required for bool */
+#include <stdbool.h>
+/* required for size_t */
+#include <stddef.h>
+
+/** alignment of the memory handed out by the arena, that of malloc */
+#define ARENA_ALIGNMENT 16
+
+/**
+ * Reserves the address space of the arena holding the long-lived state of the plugin with a
+ * single anonymous mapping. Pages are only backed by memory once they are touched.
+ *
+ * @param length bytes to reserve, allocations beyond them fall back to the heap
+ * @param hugePages whether transparent huge pages are requested for the mapping
+ * @return Returns 0 on success, a value greater than that if the arena is open already or the
+ * mapping failed, in which case all allocations fall back to the heap
+ */
+int arena_open(size_t length, bool hugePages);
+
+/**
+ * Returns zeroed memory for count elements of size bytes, aligned to ARENA_ALIGNMENT, from the
+ * arena, or from the heap if the arena is not open or exhausted. Safe for several threads.
+ *
+ * @return Returns the memory to be released by arena_free, NULL if memory ran out
+ */
+void* arena_calloc(size_t count, size_t size);
+
+/**
+ * Returns length zeroed bytes aligned to alignment, a power of two, e.g. to a cache line, from the
+ * arena, or from posix_memalign if the arena is not open or exhausted. Safe for several threads.
+ *
+ * @return Returns the memory to be released by arena_free, NULL if memory ran out
+ */
+void* arena_calloc_aligned(size_t length, size_t alignment);
+
+/**
+ * Returns whether ptr points into the arena
+ */
+bool arena_contains(const void* ptr);
+
+/**
+ * Releases memory returned by arena_calloc or arena_calloc_aligned, or by malloc. Memory of the
+ * arena is only released as a whole by arena_close, memory from the heap is freed right away.
+ */
+void arena_free(void* ptr);
+
+/**
+ * Returns the count of bytes handed out from the arena
+ */
+size_t arena_in_use(void);
+
+/**
+ * Unmaps the arena, which releases all memory handed out from it at once. No pointer into the
+ * arena may be used, or passed to arena_free, afterwards.
+ */
+void arena_close(void);
+
+#endif /* ARENA_H_ */
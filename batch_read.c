@@ -0,0 +1,156 @@
+/*
+ * batch_read.c
+ *
+ *  Created on: 19.10.2026
+ */
+#include "batch_read.h"
+
+#ifdef HAVE_LIBURING
+
+/* required for EINTR */
+#include <errno.h>
+/* required for io_uring_queue_init, io_uring_prep_read, etc. */
+#include <liburing.h>
+
+static struct io_uring ring;
+static int ringInitialized = 0;
+static unsigned int ringDepth = 0;
+
+static void drainRing(unsigned int outstanding);
+static void recreateRing(void);
+
+int batchread_init(unsigned int queueDepth)
+{
+    if (ringInitialized)
+    {
+        return 0;
+    }
+    if (1 > queueDepth)
+    {
+        queueDepth = 1;
+    }
+    /* fails on kernels without io_uring or if io_uring is blocked, e.g. by seccomp */
+    if (0 > io_uring_queue_init(queueDepth, &ring, 0))
+    {
+        return 1;
+    }
+    ringInitialized = 1;
+    ringDepth = queueDepth;
+    return 0;
+}
+
+int batchread_submit(struct batch_read_request* requests, int count)
+{
+    if (!ringInitialized)
+    {
+        return 1;
+    }
+    int submittedCount = 0;
+    while (submittedCount < count)
+    {
+        /* fill the submission queue with as many reads as fit */
+        unsigned int batchSize = 0;
+        while ((submittedCount + (int)batchSize) < count && batchSize < ringDepth)
+        {
+            struct io_uring_sqe* sqe = io_uring_get_sqe(&ring);
+            if (NULL == sqe)
+            {
+                break;
+            }
+            struct batch_read_request* request = requests + submittedCount + batchSize;
+            io_uring_prep_read(sqe, request->fd, request->buf, request->length, 0);
+            io_uring_sqe_set_data(sqe, request);
+            ++batchSize;
+        }
+        if (0 == batchSize)
+        {
+            return 2;
+        }
+
+        /* a single syscall submits the whole batch and waits for its completion */
+        if (0 > io_uring_submit_and_wait(&ring, batchSize))
+        {
+            /* it is unknown which reads are in flight, so none of them may reach the next batch */
+            recreateRing();
+            return 3;
+        }
+        for (unsigned int i = 0; i < batchSize; ++i)
+        {
+            struct io_uring_cqe* cqe = NULL;
+            if (0 > io_uring_wait_cqe(&ring, &cqe))
+            {
+                drainRing(batchSize - i);
+                return 4;
+            }
+            struct batch_read_request* request = io_uring_cqe_get_data(cqe);
+            request->result = cqe->res;
+            io_uring_cqe_seen(&ring, cqe);
+        }
+        submittedCount += batchSize;
+    }
+    return 0;
+}
+
+void batchread_destroy(void)
+{
+    if (ringInitialized)
+    {
+        io_uring_queue_exit(&ring);
+        ringInitialized = 0;
+    }
+}
+
+/**
+ * Reaps the completions of a failed batch, which the next batch would otherwise take for the results
+ * of its own reads. The ring is recreated if they can not be reaped.
+ */
+static void drainRing(unsigned int outstanding)
+{
+    while (0 < outstanding)
+    {
+        struct io_uring_cqe* cqe = NULL;
+        int result = io_uring_wait_cqe(&ring, &cqe);
+        if (-EINTR == result)
+        {
+            continue;
+        }
+        if (0 > result)
+        {
+            recreateRing();
+            return;
+        }
+        io_uring_cqe_seen(&ring, cqe);
+        --outstanding;
+    }
+}
+
+/**
+ * Replaces the ring by an empty one of the same depth, dropping all reads of the old one. If no new
+ * ring can be set up, batched reads are unavailable until the next batchread_init.
+ */
+static void recreateRing(void)
+{
+    io_uring_queue_exit(&ring);
+    ringInitialized = (0 <= io_uring_queue_init(ringDepth, &ring, 0));
+}
+
+#else /* HAVE_LIBURING */
+
+int batchread_init(unsigned int queueDepth)
+{
+    (void)queueDepth;
+    return 1;
+}
+
+int batchread_submit(struct batch_read_request* requests, int count)
+{
+    (void)requests;
+    (void)count;
+    return 1;
+}
+
+void batchread_destroy(void)
+{
+}
+
+#endif /* HAVE_LIBURING */
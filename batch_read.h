@@ -0,0 +1,49 @@
+/*
+ * batch_read.h
+ *
+ *  Created on: 19.10.2026
+ */
+
+#ifndef BATCH_READ_H_
+#define BATCH_READ_H_
+
+/* required for size_t */
+#include <stddef.h>
+/* required for ssize_t */
+#include <sys/types.h>
+
+/* A single read request of a batch, reads up to length bytes from the beginning of fd into buf */
+struct batch_read_request
+{
+    int fd;         /**< file descriptor to read from */
+    char* buf;      /**< destination of the read bytes */
+    size_t length;  /**< capacity of buf */
+    ssize_t result; /**< count of bytes read, or a negative errno if the read failed */
+};
+
+/**
+ * Sets up the submission and completion queues for batched reads
+ *
+ * @param queueDepth count of reads that may be in flight at once
+ * @return Returns 0 on success, a value greater than that if batched reads are not available (i.e.
+ * the plugin was built without liburing or the kernel does not support io_uring)
+ */
+int batchread_init(unsigned int queueDepth);
+
+/**
+ * Submits all requests at once and waits until every one of them completed
+ *
+ * Each request's result is set individually, a failed request does not fail the batch.
+ *
+ * @return Returns 0 on success, a value greater than that if the batch itself could not be
+ * submitted, in which case the results of the requests are undefined. No completion of a failed
+ * batch is left behind for the next one.
+ */
+int batchread_submit(struct batch_read_request* requests, int count);
+
+/**
+ * Releases the queues set up by batchread_init
+ */
+void batchread_destroy(void);
+
+#endif /* BATCH_READ_H_ */
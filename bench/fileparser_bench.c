@@ -0,0 +1,514 @@
+/*
+ * fileparser_bench.c
+ *
+ *  Created on: 19.10.2026
+ */
+
+/*
+ * Microbenchmarks for the parsing and storage kernels of the plugin. The plugin's translation unit
+ * is included, so its static functions can be called directly without a Score-P measurement.
+ *
+ * Usage: fileparser_bench [<iteration-scale>]
+ *
+ * The fixtures are created in $FILEPARSER_BENCH_DIR, falling back to /dev/shm (tmpfs) and $TMPDIR.
+ */
+#include "../fileparser_plugin.c"
+
+/* required for PRIu64 and SCNu64 */
+#include <inttypes.h>
+/* required for PATH_MAX */
+#include <limits.h>
+/* required for va_list */
+#include <stdarg.h>
+
+/** lines per processor in the synthetic cpuinfo, matching the layout of /proc/cpuinfo */
+#define BENCH_CPUINFO_LINES_PER_CPU 27
+#define BENCH_CPU_COUNT 1024
+#define BENCH_INTERFACE_COUNT 10000
+#define BENCH_INTERFACE_METRICS 100
+#define BENCH_BINARY_SIZE (1024 * 1024)
+#define BENCH_BINARY_METRICS 24
+#define BENCH_REGISTRATION_METRICS 5000
+
+/* The allocator is interposed to count the allocations per sample */
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+void __libc_free(void* ptr);
+
+static uint64_t allocationCount = 0;
+
+void* malloc(size_t size)
+{
+    __atomic_fetch_add(&allocationCount, 1, __ATOMIC_RELAXED);
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size)
+{
+    __atomic_fetch_add(&allocationCount, 1, __ATOMIC_RELAXED);
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* ptr, size_t size)
+{
+    __atomic_fetch_add(&allocationCount, 1, __ATOMIC_RELAXED);
+    return __libc_realloc(ptr, size);
+}
+
+int posix_memalign(void** memptr, size_t alignment, size_t size)
+{
+    __atomic_fetch_add(&allocationCount, 1, __ATOMIC_RELAXED);
+    if (0 != alignment % sizeof(void*) || 0 != (alignment & (alignment - 1)))
+    {
+        return EINVAL;
+    }
+    void* memory = __libc_memalign(alignment, size);
+    if (NULL == memory)
+    {
+        return ENOMEM;
+    }
+    *memptr = memory;
+    return 0;
+}
+
+void* aligned_alloc(size_t alignment, size_t size)
+{
+    __atomic_fetch_add(&allocationCount, 1, __ATOMIC_RELAXED);
+    return __libc_memalign(alignment, size);
+}
+
+void free(void* ptr)
+{
+    __libc_free(ptr);
+}
+
+/**
+ * Counters taken before and after running a kernel
+ */
+struct benchSnapshot
+{
+    uint64_t nanoseconds; /**< CLOCK_MONOTONIC */
+    uint64_t allocations; /**< count of calls to the allocator */
+    uint64_t bytesRead;   /**< rchar of /proc/self/io, i.e. bytes returned by read syscalls */
+};
+
+static uint64_t benchNanoseconds(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+static uint64_t benchBytesRead(void)
+{
+    uint64_t rchar = 0;
+    FILE* ioStats = fopen("/proc/self/io", "r");
+    if (NULL != ioStats)
+    {
+        if (1 != fscanf(ioStats, "rchar: %" SCNu64, &rchar))
+        {
+            rchar = 0;
+        }
+        fclose(ioStats);
+    }
+    return rchar;
+}
+
+static struct benchSnapshot benchTakeSnapshot(void)
+{
+    struct benchSnapshot snapshot;
+    snapshot.bytesRead = benchBytesRead();
+    snapshot.allocations = __atomic_load_n(&allocationCount, __ATOMIC_RELAXED);
+    snapshot.nanoseconds = benchNanoseconds();
+    return snapshot;
+}
+
+/**
+ * Prints one line of results, samplesPerIteration is the count of values extracted per iteration
+ */
+static void benchReport(const char* kernel, struct benchSnapshot* before, uint64_t iterations,
+                        uint64_t samplesPerIteration)
+{
+    struct benchSnapshot after = benchTakeSnapshot();
+    double samples = (double)iterations * samplesPerIteration;
+    printf("%-34s %10" PRIu64 " %14.1f %14.2f %14.3f %14.1f\n", kernel, iterations,
+           (after.nanoseconds - before->nanoseconds) / (double)iterations,
+           (after.nanoseconds - before->nanoseconds) / samples,
+           (after.allocations - before->allocations) / samples,
+           (after.bytesRead - before->bytesRead) / samples);
+}
+
+static void benchWriteFixture(const char* path, const char* content, size_t length)
+{
+    FILE* fixture = fopen(path, "w");
+    if (NULL == fixture || length != fwrite(content, 1, length, fixture))
+    {
+        fprintf(stderr, "Could not write fixture \"%s\".\n", path);
+        exit(1);
+    }
+    fclose(fixture);
+}
+
+/**
+ * Appends formatted text to a growing buffer
+ */
+static void benchAppend(char** buf, size_t* length, size_t* reserve, const char* format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    char line[2048];
+    int lineLength = vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+    if (*length + lineLength + 1 > *reserve)
+    {
+        *reserve = (*reserve + lineLength + 1) * 2;
+        *buf = realloc(*buf, *reserve);
+    }
+    memcpy(*buf + *length, line, lineLength + 1);
+    *length += lineLength;
+}
+
+static void benchCreateCpuinfo(const char* path)
+{
+    char* content = NULL;
+    size_t length = 0, reserve = 0;
+    for (int cpu = 0; cpu < BENCH_CPU_COUNT; ++cpu)
+    {
+        benchAppend(&content, &length, &reserve,
+                    "processor\t: %d\nvendor_id\t: GenuineIntel\ncpu family\t: 6\nmodel\t\t: 85\n"
+                    "model name\t: Intel(R) Xeon(R) Gold 6148 CPU @ 2.40GHz\nstepping\t: 4\n"
+                    "microcode\t: 0x2006906\ncpu MHz\t\t: %d.%03d\ncache size\t: 28160 KB\n"
+                    "physical id\t: %d\nsiblings\t: 40\ncore id\t\t: %d\ncpu cores\t: 20\n"
+                    "apicid\t\t: %d\ninitial apicid\t: %d\nfpu\t\t: yes\nfpu_exception\t: yes\n"
+                    "cpuid level\t: 22\nwp\t\t: yes\n",
+                    cpu, 1000 + cpu, cpu % 1000, cpu / 40, cpu % 20, cpu, cpu);
+        benchAppend(&content, &length, &reserve,
+                    "flags\t\t: fpu vme de pse tsc msr pae mce cx8 apic sep mtrr pge mca cmov pat "
+                    "pse36 clflush dts acpi mmx fxsr sse sse2 ss ht tm pbe syscall nx pdpe1gb rdtscp "
+                    "lm constant_tsc art arch_perfmon pebs bts rep_good nopl xtopology nonstop_tsc "
+                    "cpuid aperfmperf pni pclmulqdq dtes64 monitor ds_cpl vmx smx est tm2 ssse3 sdbg "
+                    "fma cx16 xtpr pdcm pcid dca sse4_1 sse4_2 x2apic movbe popcnt aes xsave avx f16c "
+                    "rdrand lahf_lm abm 3dnowprefetch avx512f avx512dq avx512cd avx512bw avx512vl\n"
+                    "bugs\t\t: cpu_meltdown spectre_v1 spectre_v2 spec_store_bypass l1tf mds\n"
+                    "bogomips\t: 4800.00\nclflush size\t: 64\ncache_alignment\t: 64\n"
+                    "address sizes\t: 46 bits physical, 48 bits virtual\npower management:\n\n");
+    }
+    benchWriteFixture(path, content, length);
+    free(content);
+}
+
+static void benchCreateNetDev(const char* path)
+{
+    char* content = NULL;
+    size_t length = 0, reserve = 0;
+    benchAppend(&content, &length, &reserve,
+                "Inter-|   Receive                                                |  Transmit\n"
+                " face |bytes    packets errs drop fifo frame compressed multicast|bytes    packets "
+                "errs drop fifo colls carrier compressed\n");
+    for (int interface = 0; interface < BENCH_INTERFACE_COUNT; ++interface)
+    {
+        benchAppend(&content, &length, &reserve,
+                    "veth%05d: %d %d 0 0 0 0 0 0 %d %d 0 0 0 0 0 0\n", interface,
+                    interface * 1500, interface, interface * 700, interface / 2);
+    }
+    benchWriteFixture(path, content, length);
+    free(content);
+}
+
+static void benchCreateBinary(const char* path)
+{
+    char* content = calloc(1, BENCH_BINARY_SIZE);
+    for (uint64_t offset = 0; offset + sizeof(uint64_t) <= BENCH_BINARY_SIZE;
+         offset += sizeof(uint64_t))
+    {
+        memcpy(content + offset, &offset, sizeof(offset));
+    }
+    benchWriteFixture(path, content, BENCH_BINARY_SIZE);
+    free(content);
+}
+
+/**
+ * Registers a metric the way Score-P would, without starting the logging thread
+ */
+static void benchRegister(const char* spec)
+{
+    char* specDup = strdup(spec);
+    SCOREP_Metric_Plugin_MetricProperties* properties = get_event_info(specDup);
+    if (NULL == properties || NULL == properties[0].name)
+    {
+        fprintf(stderr, "Could not register \"%s\".\n", spec);
+        exit(1);
+    }
+    for (int i = 0; NULL != properties[i].name; ++i)
+    {
+        free(properties[i].name);
+    }
+    free(properties);
+    free(specDup);
+}
+
+static struct fileParams* benchFindFile(const char* path)
+{
+    struct fileParams* fileSpec = hashmap_get(fileParamsByName, path);
+    if (NULL != fileSpec)
+    {
+        sortVarParams(fileSpec);
+        return fileSpec;
+    }
+    fprintf(stderr, "Could not find \"%s\" among the registered files.\n", path);
+    exit(1);
+}
+
+/**
+ * Registers count metrics on the rows of a net/dev file in descending order, the worst case for
+ * keeping the rows sorted while inserting, and then initializes their logging the way add_counter
+ * does. Both phases are reported per metric.
+ */
+static void benchRegistration(const char* path, int count)
+{
+    char spec[PATH_MAX + 128];
+    char name[64];
+    struct benchSnapshot before = benchTakeSnapshot();
+    for (int i = count - 1; i >= 0; --i)
+    {
+        int interface = i % BENCH_INTERFACE_COUNT;
+        snprintf(spec, sizeof(spec), "reg%05d:uint@%s+c=%d;r=%d;s= ", i, path,
+                 1 + i / BENCH_INTERFACE_COUNT, 2 + interface);
+        benchRegister(spec);
+    }
+    benchReport("get_event_info 5k metrics", &before, count, 1);
+    before = benchTakeSnapshot();
+    for (int i = 0; i < count; ++i)
+    {
+        snprintf(name, sizeof(name), "reg%05d", i);
+        struct varParams* varSpec = hashmap_get(varParamsByName, name);
+        if (NULL == varSpec || initializeLoggingFor(varSpec->fileSpec, varSpec))
+        {
+            fprintf(stderr, "Could not initialize logging for \"%s\".\n", name);
+            exit(1);
+        }
+    }
+    benchReport("add_counter 5k metrics", &before, count, 1);
+}
+
+/**
+ * Creates the loggers of all varParams of a file, the way add_counter does
+ */
+static int benchInitializeLogging(struct fileParams* fileSpec)
+{
+    struct Vector* definitions[] = { fileSpec->dataDefinitions, fileSpec->binaryDefinitions };
+    int metricCount = 0;
+    for (int i = 0; i < 2; ++i)
+    {
+        for (int j = 0; j < definitions[i]->length; ++j)
+        {
+            if (initializeLoggingFor(fileSpec, definitions[i]->data[j]))
+            {
+                fprintf(stderr, "Could not initialize logging for a metric of \"%s\".\n",
+                        fileSpec->filename);
+                exit(1);
+            }
+            ++metricCount;
+        }
+    }
+    return metricCount;
+}
+
+static void benchFreeFoundValues(struct Vector* foundValuesVec)
+{
+    if (NULL == foundValuesVec)
+    {
+        return;
+    }
+    for (int i = 0; i < foundValuesVec->length; ++i)
+    {
+        free(foundValuesVec->data[i]);
+    }
+    vec_destroy(foundValuesVec);
+}
+
+static void benchParseWholeFile(const char* kernel, struct fileParams* fileSpec, uint64_t iterations)
+{
+    /* warm up and count the values extracted per parse */
+    struct Vector* foundValuesVec = parseWholeFile(fileSpec, false);
+    uint64_t samplesPerIteration = (NULL != foundValuesVec) ? foundValuesVec->length : 1;
+    benchFreeFoundValues(foundValuesVec);
+
+    struct benchSnapshot before = benchTakeSnapshot();
+    for (uint64_t i = 0; i < iterations; ++i)
+    {
+        benchFreeFoundValues(parseWholeFile(fileSpec, false));
+    }
+    benchReport(kernel, &before, iterations, samplesPerIteration);
+}
+
+static void benchSampleFile(const char* kernel, struct fileParams* fileSpec, int metricCount,
+                            uint64_t iterations)
+{
+    fileSpec->isDue = true;
+    struct benchSnapshot before = benchTakeSnapshot();
+    for (uint64_t i = 0; i < iterations; ++i)
+    {
+        sampleFile(fileSpec);
+    }
+    benchReport(kernel, &before, iterations, metricCount);
+}
+
+int main(int argc, char** argv)
+{
+    uint64_t scale = (1 < argc) ? strtoull(argv[1], NULL, 0) : 1;
+    if (1 > scale)
+    {
+        scale = 1;
+    }
+    const char* directory = getenv("FILEPARSER_BENCH_DIR");
+    if (NULL == directory)
+    {
+        directory = (0 == access("/dev/shm", W_OK)) ? "/dev/shm" : getenv("TMPDIR");
+    }
+    if (NULL == directory)
+    {
+        directory = "/tmp";
+    }
+    char cpuinfoPath[PATH_MAX], netDevPath[PATH_MAX], binaryPath[PATH_MAX];
+    char registrationPath[PATH_MAX];
+    snprintf(cpuinfoPath, sizeof(cpuinfoPath), "%s/fileparser_bench_cpuinfo", directory);
+    snprintf(netDevPath, sizeof(netDevPath), "%s/fileparser_bench_net_dev", directory);
+    snprintf(binaryPath, sizeof(binaryPath), "%s/fileparser_bench_binary", directory);
+    benchCreateCpuinfo(cpuinfoPath);
+    benchCreateNetDev(netDevPath);
+    /* a file of its own, so that the metrics registered in bulk do not slow down the others */
+    snprintf(registrationPath, sizeof(registrationPath), "%s/fileparser_bench_net_dev_registration",
+             directory);
+    benchCreateNetDev(registrationPath);
+    benchCreateBinary(binaryPath);
+
+    if (init())
+    {
+        fprintf(stderr, "Could not initialize the plugin.\n");
+        return 1;
+    }
+    set_timer(benchNanoseconds);
+
+    printf("%-34s %10s %14s %14s %14s %14s\n", "kernel", "iterations", "ns/iteration", "ns/sample",
+           "allocs/sample", "bytes/sample");
+
+    /* parseValue and parseValueBinary */
+    char intStr[] = "123456789";
+    char doubleStr[] = "2100.000";
+    char hexStr[] = "0x1f2e3d4c";
+    uint64_t sink = 0;
+    uint64_t iterations = 1000000 * scale;
+    struct benchSnapshot before = benchTakeSnapshot();
+    for (uint64_t i = 0; i < iterations; ++i)
+    {
+        sink += parseValue(intStr, SCOREP_METRIC_VALUE_INT64, 0);
+    }
+    benchReport("parseValue int", &before, iterations, 1);
+    before = benchTakeSnapshot();
+    for (uint64_t i = 0; i < iterations; ++i)
+    {
+        sink += parseValue(doubleStr, SCOREP_METRIC_VALUE_DOUBLE, 0);
+    }
+    benchReport("parseValue double", &before, iterations, 1);
+    before = benchTakeSnapshot();
+    for (uint64_t i = 0; i < iterations; ++i)
+    {
+        sink += parseValue(hexStr, SCOREP_METRIC_VALUE_UINT64, 1);
+    }
+    benchReport("parseValue uint_hex", &before, iterations, 1);
+    before = benchTakeSnapshot();
+    for (uint64_t i = 0; i < iterations; ++i)
+    {
+        sink += parseValueBinary(intStr, 8, FILEPARSER_BINARY_DATATYPE_UINT64);
+    }
+    benchReport("parseValueBinary uint64", &before, iterations, 1);
+
+    /* blobarray_append, with changing and with repeated values */
+    struct blob_holder* container = blobarray_create(BLOBARRAY_INIT_BUF, 0);
+    before = benchTakeSnapshot();
+    for (uint64_t i = 0; i < iterations; ++i)
+    {
+        blobarray_append(container, i, i, 0, SCOREP_METRIC_VALUE_UINT64);
+    }
+    benchReport("blobarray_append changing", &before, iterations, 1);
+    blobarray_reset(container);
+    before = benchTakeSnapshot();
+    for (uint64_t i = 0; i < iterations; ++i)
+    {
+        blobarray_append(container, 42, i, 1, SCOREP_METRIC_VALUE_UINT64);
+    }
+    benchReport("blobarray_append repeated", &before, iterations, 1);
+    blobarray_destroy_subelements(container);
+    arena_free(container);
+
+    /* register the fixtures: the clock of every cpu, 100 interfaces and 24 binary values */
+    char spec[PATH_MAX + 128];
+    for (int cpu = 0; cpu < BENCH_CPU_COUNT; ++cpu)
+    {
+        snprintf(spec, sizeof(spec), "cpu%d MHz:double@%s+c=2;r=%d;s= ", cpu, cpuinfoPath,
+                 7 + cpu * BENCH_CPUINFO_LINES_PER_CPU);
+        benchRegister(spec);
+    }
+    for (int i = 0; i < BENCH_INTERFACE_METRICS; ++i)
+    {
+        int interface = i * (BENCH_INTERFACE_COUNT / BENCH_INTERFACE_METRICS);
+        snprintf(spec, sizeof(spec), "veth%05d rx:uint@%s+c=1;r=%d;s= ", interface, netDevPath,
+                 2 + interface);
+        benchRegister(spec);
+    }
+    for (int i = 0; i < BENCH_BINARY_METRICS; ++i)
+    {
+        /* 16 values scattered across the file, 8 adjacent ones at its end */
+        uint64_t offset = (i < 16) ? (uint64_t)i * (BENCH_BINARY_SIZE / 16)
+                                   : BENCH_BINARY_SIZE - (uint64_t)(BENCH_BINARY_METRICS - i) * 8;
+        snprintf(spec, sizeof(spec), "bin%d:uint64_bin@%s+b=%" PRIu64, i, binaryPath, offset);
+        benchRegister(spec);
+    }
+
+    /* processLine on a single line of cpuinfo */
+    struct fileParams* cpuinfoSpec = benchFindFile(cpuinfoPath);
+    cpuinfoSpec->isAccessible = 1;
+    char cpuMhzLine[] = "cpu MHz\t\t: 2100.000";
+    iterations = 200000 * scale;
+    struct Vector* foundValuesVec = vec_create(1);
+    before = benchTakeSnapshot();
+    for (uint64_t i = 0; i < iterations; ++i)
+    {
+        int varParamsIndex = 0;
+        processLine(cpuinfoSpec, cpuinfoSpec->textColumns, &varParamsIndex, 7, foundValuesVec,
+                    cpuMhzLine, false);
+        free(foundValuesVec->data[0]);
+        foundValuesVec->length = 0;
+    }
+    benchReport("processLine cpuinfo", &before, iterations, 1);
+    vec_destroy(foundValuesVec);
+
+    /* parseWholeFile and sampleFile on the fixtures */
+    struct fileParams* netDevSpec = benchFindFile(netDevPath);
+    struct fileParams* binarySpec = benchFindFile(binaryPath);
+    netDevSpec->isAccessible = 1;
+    binarySpec->isAccessible = 1;
+    benchParseWholeFile("parseWholeFile cpuinfo 1024 cpus", cpuinfoSpec, 20 * scale);
+    benchParseWholeFile("parseWholeFile net/dev 10k ifaces", netDevSpec, 20 * scale);
+    benchParseWholeFile("parseWholeFile binary 1 MiB", binarySpec, 20000 * scale);
+
+    int cpuinfoMetrics = benchInitializeLogging(cpuinfoSpec);
+    int netDevMetrics = benchInitializeLogging(netDevSpec);
+    int binaryMetrics = benchInitializeLogging(binarySpec);
+    benchSampleFile("sampleFile cpuinfo 1024 cpus", cpuinfoSpec, cpuinfoMetrics, 20 * scale);
+    benchSampleFile("sampleFile net/dev 10k ifaces", netDevSpec, netDevMetrics, 20 * scale);
+    benchSampleFile("sampleFile binary 1 MiB", binarySpec, binaryMetrics, 20000 * scale);
+
+    /* registration of thousands of metrics, dominated by the initial parse without an index */
+    benchRegistration(registrationPath, BENCH_REGISTRATION_METRICS);
+
+    fini();
+    unlink(cpuinfoPath);
+    unlink(netDevPath);
+    unlink(registrationPath);
+    unlink(binaryPath);
+    return (0 == sink) ? 1 : 0;
+}
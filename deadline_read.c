@@ -0,0 +1,362 @@
+/*
+ * deadline_read.c
+ *
+ *  Created on: 19.10.2026
+ */
+
+#include "deadline_read.h"
+
+/* required for errno */
+#include <errno.h>
+/* required for pthread_create, pthread_cond_timedwait */
+#include <pthread.h>
+/* required for malloc, realloc, free */
+#include <stdlib.h>
+/* required for memcpy */
+#include <string.h>
+/* required for clock_gettime, CLOCK_MONOTONIC */
+#include <time.h>
+/* required for pread, dup, close */
+#include <unistd.h>
+
+/** initial size of the buffer holding the whole content of a file */
+#define DEADLINE_READ_INIT_BUFSIZE 4096
+
+/**
+ * What the thread of a reader is doing
+ */
+typedef enum Deadline_Read_State
+{
+    DEADLINE_READ_IDLE,      /**< no read was posted since the results were taken */
+    DEADLINE_READ_REQUESTED, /**< a read was posted, but the thread did not pick it up yet */
+    DEADLINE_READ_READING,   /**< the thread is reading */
+    DEADLINE_READ_DONE       /**< the posted read completed */
+} Deadline_Read_State;
+
+struct deadline_reader
+{
+    pthread_t thread;                   /**< thread doing the reads */
+    pthread_mutex_t mutex;              /**< guards state and shutdown */
+    pthread_cond_t cond;                /**< signals posts to the thread and completions back */
+    int fd;                             /**< descriptor owned by the reader */
+    Deadline_Read_State state;          /**< progress of the latest post */
+    bool shutdown;                      /**< the thread shall stop */
+    bool detached;                      /**< the thread releases the reader when it stops */
+    bool wholeFile;                     /**< whether the posted read covers the whole file */
+    char* content;                      /**< the whole content of the file */
+    size_t contentReserve;              /**< how much space is allocated for content */
+    ssize_t contentLength;              /**< count of valid bytes in content, -1 if not read */
+    struct deadline_read_range* ranges; /**< the ranges of the posted read */
+    int rangeCount;                     /**< count of elements in ranges */
+    int rangeReserve;                   /**< count of elements allocated for ranges */
+    char* rangeBuf;                     /**< holds the bytes of all ranges */
+    size_t rangeBufReserve;             /**< how much space is allocated for rangeBuf */
+    uint64_t bytesRead;                 /**< count of bytes returned by the reads of the post */
+    uint64_t readStart;                 /**< CLOCK_MONOTONIC time in ns the reads began */
+    uint64_t readEnd;                   /**< CLOCK_MONOTONIC time in ns the reads ended */
+};
+
+static void* readerThread(void* argument);
+static void readWholeFile(struct deadline_reader* reader);
+static void readRanges(struct deadline_reader* reader);
+static void freeReader(struct deadline_reader* reader);
+static uint64_t monotonicNanoseconds(void);
+
+struct deadline_reader* deadlineread_create(int fd)
+{
+    struct deadline_reader* reader = calloc(1, sizeof(struct deadline_reader));
+    if (NULL == reader)
+    {
+        return NULL;
+    }
+    reader->fd = dup(fd);
+    reader->contentLength = -1;
+    pthread_condattr_t condAttr;
+    pthread_condattr_init(&condAttr);
+    pthread_condattr_setclock(&condAttr, CLOCK_MONOTONIC);
+    bool initialized = (-1 != reader->fd) && 0 == pthread_mutex_init(&reader->mutex, NULL);
+    if (initialized && pthread_cond_init(&reader->cond, &condAttr))
+    {
+        pthread_mutex_destroy(&reader->mutex);
+        initialized = false;
+    }
+    pthread_condattr_destroy(&condAttr);
+    if (!initialized)
+    {
+        if (-1 != reader->fd)
+        {
+            close(reader->fd);
+        }
+        free(reader);
+        return NULL;
+    }
+    if (pthread_create(&reader->thread, NULL, readerThread, reader))
+    {
+        freeReader(reader);
+        return NULL;
+    }
+    return reader;
+}
+
+int deadlineread_post(struct deadline_reader* reader, bool wholeFile,
+                      const struct deadline_read_range* ranges, int rangeCount,
+                      size_t rangeBufLength)
+{
+    pthread_mutex_lock(&reader->mutex);
+    if (DEADLINE_READ_REQUESTED == reader->state || DEADLINE_READ_READING == reader->state)
+    {
+        pthread_mutex_unlock(&reader->mutex);
+        return 1;
+    }
+    /* the thread is idle, so the buffers can be resized without holding the mutex */
+    pthread_mutex_unlock(&reader->mutex);
+    if (rangeCount > reader->rangeReserve)
+    {
+        struct deadline_read_range* reallocRanges =
+            realloc(reader->ranges, rangeCount * sizeof(struct deadline_read_range));
+        if (NULL == reallocRanges)
+        {
+            return 2;
+        }
+        reader->ranges = reallocRanges;
+        reader->rangeReserve = rangeCount;
+    }
+    if (rangeBufLength > reader->rangeBufReserve)
+    {
+        char* reallocBuf = realloc(reader->rangeBuf, rangeBufLength);
+        if (NULL == reallocBuf)
+        {
+            return 3;
+        }
+        reader->rangeBuf = reallocBuf;
+        reader->rangeBufReserve = rangeBufLength;
+    }
+    if (0 < rangeCount)
+    {
+        memcpy(reader->ranges, ranges, rangeCount * sizeof(struct deadline_read_range));
+    }
+    reader->rangeCount = rangeCount;
+    reader->wholeFile = wholeFile;
+
+    pthread_mutex_lock(&reader->mutex);
+    reader->state = DEADLINE_READ_REQUESTED;
+    pthread_cond_broadcast(&reader->cond);
+    pthread_mutex_unlock(&reader->mutex);
+    return 0;
+}
+
+int deadlineread_wait(struct deadline_reader* reader, uint64_t deadline)
+{
+    struct timespec until;
+    until.tv_sec = deadline / 1000000000;
+    until.tv_nsec = deadline % 1000000000;
+    int result = 0;
+    pthread_mutex_lock(&reader->mutex);
+    while (DEADLINE_READ_REQUESTED == reader->state || DEADLINE_READ_READING == reader->state)
+    {
+        if (ETIMEDOUT == pthread_cond_timedwait(&reader->cond, &reader->mutex, &until))
+        {
+            break;
+        }
+    }
+    if (DEADLINE_READ_DONE == reader->state)
+    {
+        reader->state = DEADLINE_READ_IDLE;
+    }
+    else
+    {
+        result = 1;
+    }
+    pthread_mutex_unlock(&reader->mutex);
+    return result;
+}
+
+ssize_t deadlineread_swap_content(struct deadline_reader* reader, char** buf, size_t* reserve)
+{
+    ssize_t length = reader->contentLength;
+    if (0 > length)
+    {
+        return -1;
+    }
+    char* swapBuf = *buf;
+    size_t swapReserve = *reserve;
+    *buf = reader->content;
+    *reserve = reader->contentReserve;
+    reader->content = swapBuf;
+    reader->contentReserve = swapReserve;
+    reader->contentLength = -1;
+    return length;
+}
+
+const char* deadlineread_ranges(struct deadline_reader* reader,
+                                const struct deadline_read_range** ranges)
+{
+    *ranges = reader->ranges;
+    return reader->rangeBuf;
+}
+
+uint64_t deadlineread_bytes_read(struct deadline_reader* reader)
+{
+    return reader->bytesRead;
+}
+
+void deadlineread_read_time(struct deadline_reader* reader, uint64_t* start, uint64_t* end)
+{
+    *start = reader->readStart;
+    *end = reader->readEnd;
+}
+
+void deadlineread_destroy(struct deadline_reader* reader)
+{
+    if (NULL == reader)
+    {
+        return;
+    }
+    pthread_mutex_lock(&reader->mutex);
+    reader->shutdown = true;
+    /* the read may never return, the thread releases the reader itself */
+    reader->detached = (DEADLINE_READ_READING == reader->state);
+    bool isDetached = reader->detached;
+    pthread_t thread = reader->thread;
+    pthread_cond_broadcast(&reader->cond);
+    pthread_mutex_unlock(&reader->mutex);
+    if (isDetached)
+    {
+        pthread_detach(thread);
+        return;
+    }
+    pthread_join(thread, NULL);
+    freeReader(reader);
+}
+
+/**
+ * Waits for posts and reads the requested parts of the file
+ */
+static void* readerThread(void* argument)
+{
+    struct deadline_reader* reader = argument;
+    pthread_mutex_lock(&reader->mutex);
+    while (!reader->shutdown)
+    {
+        if (DEADLINE_READ_REQUESTED != reader->state)
+        {
+            pthread_cond_wait(&reader->cond, &reader->mutex);
+            continue;
+        }
+        reader->state = DEADLINE_READ_READING;
+        pthread_mutex_unlock(&reader->mutex);
+
+        reader->bytesRead = 0;
+        reader->readStart = monotonicNanoseconds();
+        if (reader->wholeFile)
+        {
+            readWholeFile(reader);
+        }
+        readRanges(reader);
+        reader->readEnd = monotonicNanoseconds();
+
+        pthread_mutex_lock(&reader->mutex);
+        reader->state = DEADLINE_READ_DONE;
+        pthread_cond_broadcast(&reader->cond);
+    }
+    /* a reader whose thread was detached in a read is released here */
+    bool isDetached = reader->detached;
+    pthread_mutex_unlock(&reader->mutex);
+    if (isDetached)
+    {
+        freeReader(reader);
+    }
+    return NULL;
+}
+
+/**
+ * Reads the file from its beginning until EOF, growing the content buffer as required
+ */
+static void readWholeFile(struct deadline_reader* reader)
+{
+    reader->contentLength = -1;
+    if (NULL == reader->content)
+    {
+        reader->content = malloc(DEADLINE_READ_INIT_BUFSIZE);
+        if (NULL == reader->content)
+        {
+            return;
+        }
+        reader->contentReserve = DEADLINE_READ_INIT_BUFSIZE;
+    }
+    size_t length = 0;
+    while (true)
+    {
+        if (length == reader->contentReserve)
+        {
+            char* reallocContent = realloc(reader->content, reader->contentReserve * 2);
+            if (NULL == reallocContent)
+            {
+                return;
+            }
+            reader->content = reallocContent;
+            reader->contentReserve *= 2;
+        }
+        ssize_t readReturn =
+            pread(reader->fd, reader->content + length, reader->contentReserve - length, length);
+        if (0 > readReturn)
+        {
+            return;
+        }
+        if (0 == readReturn)
+        {
+            break;
+        }
+        length += readReturn;
+        reader->bytesRead += readReturn;
+    }
+    reader->contentLength = length;
+}
+
+/**
+ * Reads the bytes of all ranges, a single pread per range unless the file delivers less bytes
+ */
+static void readRanges(struct deadline_reader* reader)
+{
+    for (int i = 0; i < reader->rangeCount; ++i)
+    {
+        struct deadline_read_range* range = reader->ranges + i;
+        range->bytesRead = 0;
+        while ((size_t)range->bytesRead < range->length)
+        {
+            ssize_t readReturn =
+                pread(reader->fd, reader->rangeBuf + range->bufOffset + range->bytesRead,
+                      range->length - range->bytesRead, range->offset + range->bytesRead);
+            if (0 >= readReturn)
+            {
+                break;
+            }
+            range->bytesRead += readReturn;
+            reader->bytesRead += readReturn;
+        }
+    }
+}
+
+/**
+ * Releases the descriptor, the synchronization and the buffers of a reader whose thread ended
+ */
+static void freeReader(struct deadline_reader* reader)
+{
+    close(reader->fd);
+    pthread_cond_destroy(&reader->cond);
+    pthread_mutex_destroy(&reader->mutex);
+    free(reader->content);
+    free(reader->ranges);
+    free(reader->rangeBuf);
+    free(reader);
+}
+
+/**
+ * Returns the current CLOCK_MONOTONIC time in nanoseconds
+ */
+static uint64_t monotonicNanoseconds(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000 + now.tv_nsec;
+}
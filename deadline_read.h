@@ -0,0 +1,90 @@
+/*
+ * deadline_read.h
+ *
+ *  Created on: 19.10.2026
+ */
+
+#ifndef DEADLINE_READ_H_
+#define DEADLINE_READ_H_
+
+/* required for bool */
+#include <stdbool.h>
+/* required for size_t */
+#include <stddef.h>
+/* required for uint64_t */
+#include <stdint.h>
+/* required for ssize_t */
+#include <sys/types.h>
+
+/* A range of bytes of a file to be read by a deadline reader */
+struct deadline_read_range
+{
+    uint64_t offset;   /**< offset of the first byte within the file */
+    size_t length;     /**< count of bytes to be read */
+    size_t bufOffset;  /**< where the bytes are stored within the range buffer of the reader */
+    ssize_t bytesRead; /**< count of bytes actually read, set once the read completed */
+};
+
+/* Reads a single file on a thread of its own, so that a stalled read only delays that file */
+struct deadline_reader;
+
+/**
+ * Starts the reading thread of a file
+ *
+ * @param fd file descriptor to read from, which is duplicated, so fd may be closed afterwards
+ * @return Returns the reader, NULL if the thread or the descriptor could not be created
+ */
+struct deadline_reader* deadlineread_create(int fd);
+
+/**
+ * Requests a read of the whole content of the file and/or of the given ranges, whose results are
+ * stored at their bufOffset within a buffer of rangeBufLength bytes
+ *
+ * @return Returns 0 on success, a value greater than that if the previous read did not complete
+ * yet or memory could not be allocated, in which case nothing is read
+ */
+int deadlineread_post(struct deadline_reader* reader, bool wholeFile,
+                      const struct deadline_read_range* ranges, int rangeCount,
+                      size_t rangeBufLength);
+
+/**
+ * Waits for the posted read until the CLOCK_MONOTONIC time deadline in nanoseconds
+ *
+ * @return Returns 0 if the read completed, a value greater than that if the deadline passed
+ */
+int deadlineread_wait(struct deadline_reader* reader, uint64_t deadline);
+
+/**
+ * Hands the content read by a completed read of the whole file over to the caller by swapping
+ * buffers: *buf and *reserve are replaced by the buffer of the reader, which keeps the caller's
+ * buffer for its next read
+ *
+ * @return Returns the count of bytes read, -1 if the whole file was not read
+ */
+ssize_t deadlineread_swap_content(struct deadline_reader* reader, char** buf, size_t* reserve);
+
+/**
+ * Returns the ranges and the range buffer of a completed read, which stay valid until the next
+ * post
+ */
+const char* deadlineread_ranges(struct deadline_reader* reader,
+                                const struct deadline_read_range** ranges);
+
+/**
+ * Returns the count of bytes returned by the reads of a completed post
+ */
+uint64_t deadlineread_bytes_read(struct deadline_reader* reader);
+
+/**
+ * Returns the CLOCK_MONOTONIC times in nanoseconds at which the reads of a completed post began and
+ * ended
+ */
+void deadlineread_read_time(struct deadline_reader* reader, uint64_t* start, uint64_t* end);
+
+/**
+ * Stops the thread of a reader. A thread stuck in a read is left behind and releases the reader
+ * once the read returns.
+ */
+void deadlineread_destroy(struct deadline_reader* reader);
+
+#endif /* DEADLINE_READ_H_ */
@@ -0,0 +1,519 @@
+/*
+ * derived_metric.c
+ *
+ *  Created on: 19.10.2026
+ */
+
+#include "derived_metric.h"
+
+/* required for isalnum, isalpha, isdigit, isspace */
+#include <ctype.h>
+/* required for va_list */
+#include <stdarg.h>
+/* required for vsnprintf */
+#include <stdio.h>
+/* required for malloc, realloc, free, strtod */
+#include <stdlib.h>
+/* required for strchr, strcmp, memcpy */
+#include <string.h>
+
+/** count of matches of a name that are looked up without allocating memory */
+#define DERIVED_METRIC_INLINE_MATCHES 16
+
+/* The state of the compilation of an expression */
+struct derivedParser
+{
+    const char* expression;          /**< the whole expression, for error messages */
+    const char* pos;                 /**< the next character to be parsed */
+    Derived_Metric_Resolver resolve; /**< looks up the metrics of names */
+    void* context;                   /**< passed to resolve */
+    struct derived_metric* metric;   /**< the program being emitted */
+    int programReserve;              /**< count of instructions allocated for the program */
+    int sourcesReserve;              /**< count of sources allocated */
+    int depth;                       /**< count of values on the stack after the program so far */
+    int result;                      /**< the first error, 0 while there is none */
+    char* error;                     /**< receives the description of the first error */
+    size_t errorLength;              /**< size of error */
+};
+
+static void parseExpression(struct derivedParser* parser);
+
+/**
+ * Records an error unless an earlier one was recorded already
+ */
+static void fail(struct derivedParser* parser, int result, const char* format, ...)
+{
+    if (0 != parser->result)
+    {
+        return;
+    }
+    parser->result = result;
+    if (NULL != parser->error && 0 < parser->errorLength)
+    {
+        va_list arguments;
+        va_start(arguments, format);
+        vsnprintf(parser->error, parser->errorLength, format, arguments);
+        va_end(arguments);
+    }
+}
+
+static void skipSpaces(struct derivedParser* parser)
+{
+    while (isspace((unsigned char)*parser->pos))
+    {
+        ++parser->pos;
+    }
+}
+
+/**
+ * Reports the position of the parser as an error of a malformed expression
+ */
+static void failAtPosition(struct derivedParser* parser, const char* expected)
+{
+    if ('\0' == *parser->pos)
+    {
+        fail(parser, 1, "expected %s at the end of \"%s\"", expected, parser->expression);
+    }
+    else
+    {
+        fail(parser, 1, "expected %s at offset %d of \"%s\"", expected,
+             (int)(parser->pos - parser->expression), parser->expression);
+    }
+}
+
+/**
+ * Appends an instruction to the program and keeps track of the depth of the stack
+ */
+static void emit(struct derivedParser* parser, Derived_Metric_Op op, int source, double constant)
+{
+    if (0 != parser->result)
+    {
+        return;
+    }
+    struct derived_metric* metric = parser->metric;
+    if (metric->length == parser->programReserve)
+    {
+        int newReserve = (0 < parser->programReserve) ? 2 * parser->programReserve : 8;
+        struct derived_metric_instruction* newProgram =
+            realloc(metric->program, newReserve * sizeof(struct derived_metric_instruction));
+        if (NULL == newProgram)
+        {
+            fail(parser, 3, "out of memory");
+            return;
+        }
+        metric->program = newProgram;
+        parser->programReserve = newReserve;
+    }
+    struct derived_metric_instruction* instruction = metric->program + metric->length++;
+    instruction->op = op;
+    instruction->source = source;
+    instruction->constant = constant;
+    switch (op)
+    {
+    case DERIVED_OP_CONSTANT: /* fall-through */
+    case DERIVED_OP_SOURCE:
+        ++parser->depth;
+        break;
+    case DERIVED_OP_NEG:
+        break;
+    default:
+        --parser->depth;
+        break;
+    }
+    if (parser->depth > DERIVED_METRIC_MAX_STACK)
+    {
+        fail(parser, 1, "\"%s\" is nested too deeply", parser->expression);
+    }
+}
+
+/**
+ * Returns the index of a source within the sources of the metric, which it is added to if needed
+ */
+static int sourceIndex(struct derivedParser* parser, const void* source)
+{
+    struct derived_metric* metric = parser->metric;
+    for (int i = 0; i < metric->sourceCount; ++i)
+    {
+        if (metric->sources[i] == source)
+        {
+            return i;
+        }
+    }
+    if (metric->sourceCount == parser->sourcesReserve)
+    {
+        int newReserve = (0 < parser->sourcesReserve) ? 2 * parser->sourcesReserve : 4;
+        const void** newSources = realloc(metric->sources, newReserve * sizeof(const void*));
+        if (NULL == newSources)
+        {
+            fail(parser, 3, "out of memory");
+            return -1;
+        }
+        metric->sources = newSources;
+        parser->sourcesReserve = newReserve;
+    }
+    metric->sources[metric->sourceCount] = source;
+    return metric->sourceCount++;
+}
+
+/**
+ * Reads a name, either a run of name characters or anything enclosed in braces
+ *
+ * @return Returns the name in newly allocated memory, NULL if there is no name at the position of
+ * the parser or memory ran out
+ */
+static char* readName(struct derivedParser* parser)
+{
+    const char* begin = parser->pos;
+    const char* end = begin;
+    if ('{' == *begin)
+    {
+        ++begin;
+        end = strchr(begin, '}');
+        if (NULL == end)
+        {
+            failAtPosition(parser, "a name closed by '}'");
+            return NULL;
+        }
+        parser->pos = end + 1;
+    }
+    else
+    {
+        if ('\0' == *begin || (!isalpha((unsigned char)*begin) && NULL == strchr("_.[]", *begin)))
+        {
+            return NULL;
+        }
+        while (isalnum((unsigned char)*end) || ('\0' != *end && NULL != strchr("_.[]", *end)))
+        {
+            ++end;
+        }
+        parser->pos = end;
+    }
+    char* name = malloc(end - begin + 1);
+    if (NULL == name)
+    {
+        fail(parser, 3, "out of memory");
+        return NULL;
+    }
+    memcpy(name, begin, end - begin);
+    name[end - begin] = '\0';
+    return name;
+}
+
+/**
+ * Pushes the values of all the metrics matching a name, each followed by combineOp except for the
+ * first value of a function, which operandCount counts the pushed values of
+ *
+ * @param allowMany whether the name may match several metrics, otherwise it has to match one
+ */
+static void emitName(struct derivedParser* parser, const char* name, bool allowMany,
+                     Derived_Metric_Op combineOp, int* operandCount)
+{
+    const void* inlineMatches[DERIVED_METRIC_INLINE_MATCHES];
+    const void** matches = inlineMatches;
+    int matchCount =
+        parser->resolve(name, parser->context, matches, DERIVED_METRIC_INLINE_MATCHES);
+    if (0 > matchCount)
+    {
+        fail(parser, 4, "\"%s\" refers to a metric which can not be used in an expression", name);
+        return;
+    }
+    if (matchCount > DERIVED_METRIC_INLINE_MATCHES)
+    {
+        matches = malloc(matchCount * sizeof(const void*));
+        if (NULL == matches)
+        {
+            fail(parser, 3, "out of memory");
+            return;
+        }
+        matchCount = parser->resolve(name, parser->context, matches, matchCount);
+    }
+    if (0 >= matchCount)
+    {
+        fail(parser, 2, "no metric matches \"%s\"", name);
+    }
+    else if (1 < matchCount && !allowMany)
+    {
+        fail(parser, 2, "\"%s\" matches several metrics, it may only stand for several ones as "
+                        "an argument of a function",
+             name);
+    }
+    for (int i = 0; 0 == parser->result && i < matchCount; ++i)
+    {
+        emit(parser, DERIVED_OP_SOURCE, sourceIndex(parser, matches[i]), 0);
+        if (NULL != operandCount && 0 < (*operandCount)++)
+        {
+            emit(parser, combineOp, 0, 0);
+        }
+    }
+    if (inlineMatches != matches)
+    {
+        free(matches);
+    }
+}
+
+/**
+ * Parses the arguments of a function, given the name it was called by
+ */
+static void parseFunction(struct derivedParser* parser, const char* function)
+{
+    Derived_Metric_Op combineOp = DERIVED_OP_ADD;
+    if (0 == strcmp(function, "min"))
+    {
+        combineOp = DERIVED_OP_MIN;
+    }
+    else if (0 == strcmp(function, "max"))
+    {
+        combineOp = DERIVED_OP_MAX;
+    }
+    int operandCount = 0;
+    do
+    {
+        /* skip the opening parenthesis or the separator */
+        ++parser->pos;
+        skipSpaces(parser);
+        /* a name standing alone may match several metrics */
+        const char* argumentStart = parser->pos;
+        char* name = ('(' != *parser->pos) ? readName(parser) : NULL;
+        skipSpaces(parser);
+        if (NULL != name && (';' == *parser->pos || ')' == *parser->pos))
+        {
+            emitName(parser, name, true, combineOp, &operandCount);
+        }
+        else
+        {
+            parser->pos = argumentStart;
+            parseExpression(parser);
+            if (0 < operandCount++)
+            {
+                emit(parser, combineOp, 0, 0);
+            }
+        }
+        free(name);
+        skipSpaces(parser);
+    } while (0 == parser->result && ';' == *parser->pos);
+    if (')' != *parser->pos)
+    {
+        failAtPosition(parser, "';' or ')'");
+        return;
+    }
+    ++parser->pos;
+    if (0 == strcmp(function, "avg"))
+    {
+        emit(parser, DERIVED_OP_CONSTANT, 0, operandCount);
+        emit(parser, DERIVED_OP_DIV, 0, 0);
+    }
+}
+
+static void parseFactor(struct derivedParser* parser)
+{
+    skipSpaces(parser);
+    const char* pos = parser->pos;
+    if ('-' == *pos)
+    {
+        ++parser->pos;
+        parseFactor(parser);
+        emit(parser, DERIVED_OP_NEG, 0, 0);
+    }
+    else if ('(' == *pos)
+    {
+        ++parser->pos;
+        parseExpression(parser);
+        skipSpaces(parser);
+        if (')' != *parser->pos)
+        {
+            failAtPosition(parser, "')'");
+            return;
+        }
+        ++parser->pos;
+    }
+    else if (isdigit((unsigned char)*pos) || ('.' == *pos && isdigit((unsigned char)pos[1])))
+    {
+        char* end = NULL;
+        double constant = strtod(pos, &end);
+        parser->pos = end;
+        emit(parser, DERIVED_OP_CONSTANT, 0, constant);
+    }
+    else
+    {
+        char* name = readName(parser);
+        if (NULL == name)
+        {
+            failAtPosition(parser, "a number, a name or '('");
+            return;
+        }
+        skipSpaces(parser);
+        if ('(' == *parser->pos && '{' != *pos)
+        {
+            if (0 == strcmp(name, "sum") || 0 == strcmp(name, "avg") ||
+                0 == strcmp(name, "min") || 0 == strcmp(name, "max"))
+            {
+                parseFunction(parser, name);
+            }
+            else
+            {
+                fail(parser, 1, "unknown function \"%s\" in \"%s\"", name, parser->expression);
+            }
+        }
+        else
+        {
+            emitName(parser, name, false, DERIVED_OP_ADD, NULL);
+        }
+        free(name);
+    }
+}
+
+static void parseTerm(struct derivedParser* parser)
+{
+    parseFactor(parser);
+    skipSpaces(parser);
+    while (0 == parser->result && ('*' == *parser->pos || '/' == *parser->pos))
+    {
+        Derived_Metric_Op op = ('*' == *parser->pos) ? DERIVED_OP_MUL : DERIVED_OP_DIV;
+        ++parser->pos;
+        parseFactor(parser);
+        emit(parser, op, 0, 0);
+        skipSpaces(parser);
+    }
+}
+
+static void parseExpression(struct derivedParser* parser)
+{
+    parseTerm(parser);
+    skipSpaces(parser);
+    while (0 == parser->result && ('+' == *parser->pos || '-' == *parser->pos))
+    {
+        Derived_Metric_Op op = ('+' == *parser->pos) ? DERIVED_OP_ADD : DERIVED_OP_SUB;
+        ++parser->pos;
+        parseTerm(parser);
+        emit(parser, op, 0, 0);
+        skipSpaces(parser);
+    }
+}
+
+bool derivedmetric_match(const char* pattern, const char* name)
+{
+    /* the name position to retry from when the characters following the latest '*' mismatch */
+    const char* retryPattern = NULL;
+    const char* retryName = NULL;
+    while ('\0' != *name)
+    {
+        if ('*' == *pattern)
+        {
+            retryPattern = ++pattern;
+            retryName = name;
+        }
+        else if (*pattern == *name)
+        {
+            ++pattern;
+            ++name;
+        }
+        else if (NULL != retryPattern)
+        {
+            pattern = retryPattern;
+            name = ++retryName;
+        }
+        else
+        {
+            return false;
+        }
+    }
+    while ('*' == *pattern)
+    {
+        ++pattern;
+    }
+    return '\0' == *pattern;
+}
+
+int derivedmetric_compile(const char* expression, Derived_Metric_Resolver resolve, void* context,
+                          struct derived_metric** metric, char* error, size_t errorLength)
+{
+    struct derivedParser parser = { 0 };
+    parser.expression = expression;
+    parser.pos = expression;
+    parser.resolve = resolve;
+    parser.context = context;
+    parser.error = error;
+    parser.errorLength = errorLength;
+    parser.metric = calloc(1, sizeof(struct derived_metric));
+    if (NULL == parser.metric)
+    {
+        fail(&parser, 3, "out of memory");
+        return parser.result;
+    }
+    parseExpression(&parser);
+    skipSpaces(&parser);
+    if ('\0' != *parser.pos)
+    {
+        failAtPosition(&parser, "an operator");
+    }
+    if (0 != parser.result)
+    {
+        derivedmetric_destroy(parser.metric);
+        return parser.result;
+    }
+    *metric = parser.metric;
+    return 0;
+}
+
+int derivedmetric_evaluate(const struct derived_metric* metric, Derived_Metric_Getter get,
+                           double* result)
+{
+    double stack[DERIVED_METRIC_MAX_STACK];
+    int top = -1;
+    for (int i = 0; i < metric->length; ++i)
+    {
+        const struct derived_metric_instruction* instruction = metric->program + i;
+        switch (instruction->op)
+        {
+        case DERIVED_OP_CONSTANT:
+            stack[++top] = instruction->constant;
+            break;
+        case DERIVED_OP_SOURCE:
+            if (!get(metric->sources[instruction->source], &stack[++top]))
+            {
+                return 1;
+            }
+            break;
+        case DERIVED_OP_ADD:
+            --top;
+            stack[top] += stack[top + 1];
+            break;
+        case DERIVED_OP_SUB:
+            --top;
+            stack[top] -= stack[top + 1];
+            break;
+        case DERIVED_OP_MUL:
+            --top;
+            stack[top] *= stack[top + 1];
+            break;
+        case DERIVED_OP_DIV:
+            --top;
+            stack[top] /= stack[top + 1];
+            break;
+        case DERIVED_OP_MIN:
+            --top;
+            stack[top] = (stack[top + 1] < stack[top]) ? stack[top + 1] : stack[top];
+            break;
+        case DERIVED_OP_MAX:
+            --top;
+            stack[top] = (stack[top + 1] > stack[top]) ? stack[top + 1] : stack[top];
+            break;
+        case DERIVED_OP_NEG:
+            stack[top] = -stack[top];
+            break;
+        }
+    }
+    *result = stack[0];
+    return 0;
+}
+
+void derivedmetric_destroy(struct derived_metric* metric)
+{
+    if (NULL == metric)
+    {
+        return;
+    }
+    free(metric->program);
+    free(metric->sources);
+    free(metric);
+}
@@ -0,0 +1,113 @@
+/*
+ * derived_metric.h
+ *
+ *  Created on: 19.10.2026
+ */
+
+#ifndef DERIVED_METRIC_H_
+#define DERIVED_METRIC_H_
+
+/* required for bool */
+#include <stdbool.h>
+/* required for size_t */
+#include <stddef.h>
+
+/** depth of the stack a derived metric is evaluated on, deeper expressions are rejected */
+#define DERIVED_METRIC_MAX_STACK 32
+
+/*
+ * Expressions of derived metrics:
+ *
+ *   expression := term { ('+' | '-') term }
+ *   term       := factor { ('*' | '/') factor }
+ *   factor     := '-' factor | number | name | function '(' argument { ';' argument } ')'
+ *                 | '(' expression ')'
+ *   function   := 'sum' | 'avg' | 'min' | 'max'
+ *   argument   := name | expression
+ *
+ * A name consists of letters, digits and the characters "_.[]" and does not begin with a digit,
+ * other names are enclosed in braces, e.g. {Load AVG}. Within braces, '*' matches any characters,
+ * e.g. {temp[*]}. Names standing alone as an argument of a function stand for all the metrics they
+ * match, any other name has to match exactly one metric.
+ */
+
+/* The operations of the stack machine a derived metric is compiled to */
+typedef enum Derived_Metric_Op
+{
+    DERIVED_OP_CONSTANT, /**< pushes the constant of the instruction */
+    DERIVED_OP_SOURCE,   /**< pushes the value of the source given by the instruction */
+    DERIVED_OP_ADD,      /**< replaces the two topmost values by their sum */
+    DERIVED_OP_SUB,      /**< replaces the two topmost values by their difference */
+    DERIVED_OP_MUL,      /**< replaces the two topmost values by their product */
+    DERIVED_OP_DIV,      /**< replaces the two topmost values by their quotient */
+    DERIVED_OP_MIN,      /**< replaces the two topmost values by the lesser one */
+    DERIVED_OP_MAX,      /**< replaces the two topmost values by the greater one */
+    DERIVED_OP_NEG       /**< negates the topmost value */
+} Derived_Metric_Op;
+
+/* An instruction of the stack machine */
+struct derived_metric_instruction
+{
+    Derived_Metric_Op op; /**< what the instruction does */
+    int source;           /**< index into the sources of the metric for DERIVED_OP_SOURCE */
+    double constant;      /**< the value pushed by DERIVED_OP_CONSTANT */
+};
+
+/* A compiled expression */
+struct derived_metric
+{
+    struct derived_metric_instruction* program; /**< the instructions in postfix order */
+    int length;                                 /**< count of instructions */
+    const void** sources; /**< the metrics the expression refers to, each only once */
+    int sourceCount;      /**< count of sources */
+};
+
+/**
+ * Looks up the metrics whose names match a name of an expression
+ *
+ * @param name the name, which may contain '*' matching any characters
+ * @param matches filled with up to capacity of the matching metrics
+ * @return Returns the count of all matching metrics, which may exceed capacity, or a negative
+ * value if a matching metric must not be referred to
+ */
+typedef int (*Derived_Metric_Resolver)(const char* name, void* context, const void** matches,
+                                       int capacity);
+
+/**
+ * Returns the current value of a source of a derived metric
+ *
+ * @return Returns whether the source has a value yet
+ */
+typedef bool (*Derived_Metric_Getter)(const void* source, double* value);
+
+/**
+ * Compiles an expression into a program for the stack machine, resolving its names once
+ *
+ * @param metric set to the compiled expression to be freed by derivedmetric_destroy
+ * @param error filled with a description of the problem on error
+ * @return Returns 0 on success, 1 if the expression is malformed, 2 if a name matches no metric or
+ * more than one where only one is allowed, 3 if memory ran out, 4 if the resolver refused a name
+ */
+int derivedmetric_compile(const char* expression, Derived_Metric_Resolver resolve, void* context,
+                          struct derived_metric** metric, char* error, size_t errorLength);
+
+/**
+ * Checks whether a name matches a pattern of an expression, in which only '*' is special, matching
+ * any characters
+ */
+bool derivedmetric_match(const char* pattern, const char* name);
+
+/**
+ * Evaluates a compiled expression on the current values of its sources without allocating memory
+ *
+ * @return Returns 0 on success, a value greater than that if some source has no value yet
+ */
+int derivedmetric_evaluate(const struct derived_metric* metric, Derived_Metric_Getter get,
+                           double* result);
+
+/**
+ * Frees a compiled expression
+ */
+void derivedmetric_destroy(struct derived_metric* metric);
+
+#endif /* DERIVED_METRIC_H_ */
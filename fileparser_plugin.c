@@ -15,8 +15,26 @@
 #include <string.h>
 /* required for struct Vector */
 #include "vector.h"
+/* required for struct HashMap */
+#include "hash_map.h"
 /* required for struct measurement_blob */
 #include "measurement_blob.h"
+/* required for batchread_init, batchread_submit */
+#include "batch_read.h"
+/* required for deadlineread_create, deadlineread_post, deadlineread_wait */
+#include "deadline_read.h"
+/* required for samplerplacement_read_env, samplerplacement_set_attr */
+#include "sampler_placement.h"
+/* required for spillfile_open, spillfile_close */
+#include "spill_file.h"
+/* required for samplelog_open, samplelog_append */
+#include "sample_log.h"
+/* required for derivedmetric_compile, derivedmetric_evaluate, derivedmetric_match */
+#include "derived_metric.h"
+/* required for periodhistogram_create, periodhistogram_add */
+#include "period_histogram.h"
+/* required for arena_open, arena_calloc, arena_free, arena_close */
+#include "arena.h"
 /* required for datatype bool */
 #include <stdbool.h>
 /* required for datatype uint64_t */
@@ -33,12 +51,102 @@
 #include <stdbool.h>
 /* required for metric plugin */
 #include <scorep/SCOREP_MetricPlugins.h>
+/* required for epoll_create1, epoll_ctl, epoll_wait */
+#include <sys/epoll.h>
+/* required for inotify_init1, inotify_add_watch */
+#include <sys/inotify.h>
+/* required for timerfd_create, timerfd_settime */
+#include <sys/timerfd.h>
+/* required for fstatfs */
+#include <sys/vfs.h>
+/* required for fstat, S_ISREG */
+#include <sys/stat.h>
+/* required for SYSFS_MAGIC, PROC_SUPER_MAGIC */
+#include <linux/magic.h>
+/* required for clock_gettime */
+#include <time.h>
+/* required for fabs */
+#include <math.h>
+/* required for mmap, munmap */
+#include <sys/mman.h>
+/* required for sched_yield */
+#include <sched.h>
+/* required for prctl, PR_SET_NAME */
+#include <sys/prctl.h>
 
 /** default buffer size for reading a file
  * MUST NOT BE SMALLER THAN 7 */
 #define DEFAULT_BUFSIZE 4096
 /** asumed default count of read logging data points */
 #define BLOBARRAY_INIT_BUF 5000
+/** minimal count of elements of the logging array a variable continues with after a pull */
+#define BLOBARRAY_PULL_MIN_BUF 16
+/** upper limit of the reads submitted to io_uring at once */
+#define BATCHREAD_MAX_QUEUE_DEPTH 1024
+/** default size of the sample log */
+#define SAMPLE_LOG_DEFAULT_SIZE (64 << 20)
+/** default count of bytes reserved for the arena holding the state of the plugin */
+#define ARENA_DEFAULT_SIZE (16 << 20)
+/** count of metrics the metric table of the sample log can describe */
+#define SAMPLE_LOG_METRIC_CAPACITY 4096
+/** gap in bytes up to which two binary values are read with a single pread */
+#define BINARY_MERGE_GAP 4096
+/** count of attempts to get a consistent read from a seqlock protected mapping */
+#define SEQLOCK_MAX_RETRIES 1000
+/** count of events fetched by a single epoll_wait */
+#define NOTIFY_MAX_EVENTS 64
+/** waits of the high-frequency sampling thread up to this many ns are spun instead of slept */
+#define HIGH_FREQUENCY_SPIN_NS 200000
+/** size of a cache line, each column of the extraction columns begins on one of its own */
+#define CACHE_LINE_SIZE 64
+/** names of the threads of the plugin, at most 15 characters */
+#define SAMPLER_THREAD_NAME "fileparser"
+#define HIGH_FREQUENCY_THREAD_NAME "fileparser-hf"
+
+/**
+ * How a file learns about changes of its content
+ */
+typedef enum Fileparser_Notify_Mode
+{
+    FILEPARSER_NOTIFY_NONE,      /**< the file is read periodically */
+    FILEPARSER_NOTIFY_REQUESTED, /**< notifications were requested but are not set up yet */
+    FILEPARSER_NOTIFY_SYSFS,     /**< sysfs attribute, poll signals POLLPRI/POLLERR on change */
+    FILEPARSER_NOTIFY_INOTIFY    /**< regular file, watched with inotify */
+} Fileparser_Notify_Mode;
+
+/**
+ * How the values of a file changed compared to the previous read
+ */
+typedef enum Fileparser_Sample_Change
+{
+    FILEPARSER_SAMPLE_REPEATED,        /**< all values were repetitions */
+    FILEPARSER_SAMPLE_CHANGED,         /**< some value changed, but stayed within the threshold */
+    FILEPARSER_SAMPLE_CHANGED_STRONGLY /**< some value changed beyond the threshold */
+} Fileparser_Sample_Change;
+
+/**
+ * Quantities describing the plugin itself, which are recorded like the values of a file
+ */
+typedef enum Fileparser_Self_Metric
+{
+    FILEPARSER_SELF_NONE,           /**< the varParams describes a value of a file */
+    FILEPARSER_SELF_CYCLE_DURATION, /**< duration of a sampling cycle in ns */
+    FILEPARSER_SELF_BYTES_READ,     /**< bytes returned by the reads of a sampling cycle */
+    FILEPARSER_SELF_SAMPLES,        /**< count of values appended in a sampling cycle */
+    FILEPARSER_SELF_OVERRUNS,       /**< count of sampling cycles that took longer than the period */
+    FILEPARSER_SELF_MEMORY,         /**< bytes allocated for the values stored by all loggers */
+    FILEPARSER_SELF_DEADLINE_MISSES, /**< count of reads of files that missed their deadline */
+    FILEPARSER_SELF_READ_LATENCY,    /**< duration of the longest read of a sampling cycle in ns */
+    FILEPARSER_SELF_DECIMATION,      /**< highest factor by which any logger decimated its values */
+    FILEPARSER_SELF_COUNT
+} Fileparser_Self_Metric;
+
+/** the quantities of the plugin itself as given in a variable definition, indexed by
+ * Fileparser_Self_Metric */
+static const char* selfMetricNames[FILEPARSER_SELF_COUNT] = {
+    NULL, "cycle_duration", "bytes_read", "samples", "overruns", "memory", "deadline_misses",
+    "read_latency", "decimation"
+};
 
 /* TODO general:
  *
@@ -51,21 +159,89 @@
  */
 struct varParams
 {
+    /* the fields touched when a found value is logged come first, to share a cache line */
+    bool doLog;                      /**< whether this value was confirmed to be logged */
+    bool hasLastValue;               /**< whether lastValue was read already */
+    int logDif;                      /**< if only a dif to the initial value shall be logged */
+    SCOREP_MetricValueType datatype; /**< datatype this variable is parsed to */
+    uint64_t lastValue;              /**< the value read most recently */
+    struct blob_holder* logger;      /**< the associated logger instance */
     int id;     /**< associated id for this spec (corresponds with logging id) */
     char* name; /**< associated name of this variable */
-    bool doLog;           /**< whether this value was confirmed to be logged */
-    struct blob_holder* logger;      /**< the associated logger instance */
-    SCOREP_MetricValueType datatype; /**< datatype this variable is parsed to */
+    uint64_t pulledCount;            /**< count of data points the latest get_all_values took
+                                        from memory, used to size the next logging array */
     int posRow;            /**< the row, i.e. line number where the sought field resides */
     int posCol;            /**< the column where the sought field resides */
     char posSep;           /**< the inter column separator */
-    int logDif;            /**< if only a dif to the initial value shall be logged */
     int logPoint;          /**< if the data is to be shown as single points instead of a line */
     int inputHex;          /**< if the read data value is to be interpreted as hex value */
     int inputBinaryWidth;  /**< if the input is to be interpreted as binary */
     uint64_t binaryOffset; /**< the offset at which the binary value can be read */
     Fileparser_Binary_Datatype binaryDatatype; /**< the datatype of binary input data */
+    struct varParams* arrayHead; /**< first element of the binary array this value belongs to,
+                                    NULL if the value is read on its own */
+    int arrayIndex;              /**< index of this value within its array */
+    int arrayCount;              /**< count of elements of the array */
+    uint64_t arrayStride;        /**< distance in bytes between the elements of the array */
+    int swapBytes;               /**< if the byte order of the input differs from the host's */
+    uint64_t* arrayValues; /**< the parsed values of all elements (only allocated for the head) */
+    int arrayValidCount;   /**< count of elements of arrayValues read in the latest read */
+    Fileparser_Self_Metric selfMetric; /**< the quantity of the plugin itself this describes,
+                                          FILEPARSER_SELF_NONE for values of files */
+    struct fileParams* fileSpec; /**< the fileParams this varParams was inserted into, NULL for
+                                    metrics of the plugin itself and derived metrics */
+    char* expression;                /**< the expression of a derived metric, NULL otherwise */
+    struct derived_metric* derived; /**< the compiled expression, NULL until all the metrics it
+                                       refers to are registered */
+};
+
+/**
+ * The fields of the text varParams of a file needed to find and parse their values, one column per
+ * field in the order of the sorted dataDefinitions. Parsing a line walks these columns instead of
+ * following the pointer to every varParams, whose other fields are only touched for the values
+ * actually found.
+ */
+struct textColumns
+{
+    int count;                        /**< count of varParams described */
+    struct varParams** varSpecs;      /**< the varParams the values are found for */
+    int* posRow;                      /**< posRow of each varParams */
+    int* posCol;                      /**< posCol of each varParams */
+    char* posSep;                     /**< posSep of each varParams */
+    char* inputHex;                   /**< inputHex of each varParams */
+    SCOREP_MetricValueType* datatype; /**< datatype of each varParams */
+    struct textColumns* replaced;     /**< the columns these replaced, kept until fini since a
+                                         parse worker may still read them */
+};
+
+/**
+ * The fields of the binary varParams of a file needed to parse their values, like textColumns in
+ * the order of the sorted binaryDefinitions
+ */
+struct binaryColumns
+{
+    int count;                                  /**< count of varParams described */
+    struct varParams** varSpecs;                /**< the varParams the values are found for */
+    uint64_t* binaryOffset;                     /**< binaryOffset of each varParams */
+    int* inputBinaryWidth;                      /**< inputBinaryWidth of each varParams */
+    Fileparser_Binary_Datatype* binaryDatatype; /**< binaryDatatype of each varParams */
+    bool* isArrayElement;                       /**< whether the varParams has an arrayHead */
+    struct binaryColumns* replaced;             /**< the columns these replaced */
+};
+
+/**
+ * A range of bytes covering the binary values of one or more consecutive varParams of a file
+ */
+struct binaryRange
+{
+    uint64_t offset;       /**< offset of the first byte within the file */
+    size_t length;         /**< count of bytes to be read */
+    size_t bufOffset;      /**< where the bytes are stored within binaryBuf of the fileParams */
+    ssize_t bytesRead;     /**< count of bytes actually read in the latest read */
+    int firstDefinition;   /**< index of the first covered varParams in binaryDefinitions */
+    int definitionCount;   /**< count of covered varParams */
 };
+
 /**
  * Holds the filename and file descriptor of a set of variable definitions which are stored in
  * dataDefinitions
@@ -79,6 +255,115 @@ struct fileParams
     struct Vector* binaryDefinitions; /**< holds structs with varParams, especially with
                                          inputBinaryWidth, binaryOffset, binaryDatatype */
     int isAccessible;                 /**< whether the file was accessible at initialization */
+    char* prefetchBuf;                /**< holds the content read by a batched read */
+    size_t prefetchReserve;           /**< how much space is allocated for prefetchBuf */
+    ssize_t prefetchLength; /**< count of valid bytes in prefetchBuf, -1 if nothing was prefetched */
+    Fileparser_Notify_Mode notifyMode; /**< whether the file is read periodically or on change */
+    int inotifyWatch;                  /**< inotify watch of the directory holding the file */
+    bool notified;                     /**< the file changed since it was read the last time */
+    bool notifyConfirmed; /**< a sysfs attribute was notified at least once, so its driver calls
+                             sysfs_notify and periodic reads are no longer needed */
+    bool isDue;                        /**< the file is to be read in the current cycle */
+    bool isAdaptive;       /**< whether the period adapts to the changes of the values */
+    int minPeriod;         /**< shortest period in microseconds when adaptive */
+    int maxPeriod;         /**< longest period in microseconds when adaptive */
+    int curPeriod;         /**< current period in microseconds when adaptive */
+    double adaptThreshold; /**< relative change of a value which resets the period to minPeriod */
+    uint64_t nextDue;      /**< CLOCK_MONOTONIC time in microseconds of the next adaptive read */
+    struct binaryRange* binaryRanges; /**< merged byte ranges covering binaryDefinitions */
+    int binaryRangeCount;             /**< count of elements in binaryRanges */
+    const struct binaryColumns* plannedColumns; /**< the binaryColumns the ranges were planned
+                                                   for, NULL if they were not planned */
+    char* binaryBuf;              /**< holds the bytes read for all binaryRanges */
+    bool useMmap;                 /**< whether the file is read through a shared mapping */
+    int64_t seqlockOffset; /**< offset of the 64-bit sequence word guarding the mapping, -1 if none */
+    char* mapping;         /**< the mapping of the file, NULL if not mapped yet */
+    size_t mappingLength;  /**< length of mapping in bytes */
+    dev_t mappingDevice;   /**< device of the file mapped */
+    ino_t mappingInode;    /**< inode of the file mapped */
+    bool checkStat;        /**< whether the file is only parsed if stat shows it changed */
+    bool isUnchanged;      /**< stat showed no change since the file was read the last time */
+    bool hasLastStat;      /**< whether the stat fields below are set */
+    dev_t statDevice;      /**< device of the file when it was read the last time */
+    ino_t statInode;       /**< inode of the file when it was read the last time */
+    off_t statSize;        /**< size of the file when it was read the last time */
+    struct timespec statModification; /**< mtime of the file when it was read the last time */
+    bool needsSorting;     /**< varParams were appended since the vectors were sorted the last time */
+    struct textColumns* textColumns;     /**< the text varParams as sorted the last time, NULL
+                                            before the first sort */
+    struct binaryColumns* binaryColumns; /**< the binary varParams as sorted the last time, NULL
+                                            before the first sort */
+    bool hasInitialValues; /**< the file was parsed for the initial values of all its varParams */
+    char* identity;        /**< "device:inode" of the file at registration, NULL if unknown */
+    int deadline;          /**< microseconds after the begin of a cycle by which the file must have
+                              been read, 0 if it is read by the sampler itself */
+    struct deadline_reader* reader; /**< thread reading the file if it has a deadline */
+    bool readPosted;                /**< a read was posted to reader in the current cycle */
+    bool binaryPrefetched;          /**< binaryRanges hold the bytes read by reader */
+    uint64_t deadlineMisses;        /**< count of reads which missed the deadline */
+    uint64_t readStart;    /**< CLOCK_MONOTONIC time in ns the latest read of the file began */
+    uint64_t readEnd;      /**< CLOCK_MONOTONIC time in ns the latest read ended, 0 if unknown */
+    uint64_t readDuration; /**< time in ns spent in the reads between readStart and readEnd */
+    bool defer;            /**< whether the content is only captured by the sampler and parsed when
+                              Score-P collects the values */
+    char* snapshots;       /**< the captured contents not parsed yet, each one preceded by a struct
+                              snapshotHeader and padded to 8 bytes */
+    size_t snapshotsLength;  /**< count of used bytes in snapshots */
+    size_t snapshotsReserve; /**< how much space is allocated for snapshots */
+    char* lastContent;       /**< the content captured most recently, to skip identical ones */
+    size_t lastContentReserve; /**< how much space is allocated for lastContent */
+    ssize_t lastContentLength; /**< count of valid bytes in lastContent, -1 if none */
+    uint64_t highFrequencyPeriod; /**< period in ns of the high-frequency sampling thread reading
+                                     the file, 0 if it is read by the sampler */
+    uint64_t highFrequencyDue;    /**< CLOCK_MONOTONIC time in ns of the next high-frequency read */
+    uint64_t highFrequencyStart;  /**< CLOCK_MONOTONIC time in ns the latest high-frequency read
+                                     began, 0 before the first one */
+    bool highFrequencyScheduled;  /**< the file is in the list of the high-frequency thread */
+    struct period_histogram* periodHistogram; /**< the periods achieved by the high-frequency
+                                                 reads */
+};
+
+/**
+ * Precedes a content captured in the snapshots of a fileParams
+ */
+struct snapshotHeader
+{
+    uint64_t timestamp; /**< when the content was read */
+    uint64_t length;    /**< count of bytes of the content following the header */
+};
+
+/**
+ * The values parsed from a single snapshot when Score-P collects the values
+ */
+struct parsedSnapshot
+{
+    struct fileParams* fileSpec;   /**< the file the snapshot was captured from */
+    const char* content;           /**< the captured content, within the taken snapshots */
+    uint64_t length;               /**< count of bytes of content */
+    uint64_t timestamp;            /**< when the content was read */
+    struct Vector* foundValuesVec; /**< the parsed values, NULL if the snapshot was not parsed */
+};
+
+/**
+ * Collects the options of a variable definition which are given as keywords instead of a single
+ * character, e.g. "notify"
+ */
+struct keywordOptions
+{
+    bool notify;      /**< read the file only when the kernel signals a change */
+    int minPeriod;    /**< shortest adaptive period in microseconds, 0 if not given */
+    int maxPeriod;    /**< longest adaptive period in microseconds, 0 if not given */
+    double threshold; /**< relative change that resets the adaptive period, -1 if not given */
+    int count;        /**< count of binary values forming an array, 0 if not given */
+    uint64_t stride;  /**< distance in bytes between the elements of an array, 0 if not given */
+    int byteOrder;    /**< __ORDER_BIG_ENDIAN__ or __ORDER_LITTLE_ENDIAN__, 0 if not given */
+    bool useMmap;     /**< read the file through a shared mapping */
+    int64_t seqlockOffset; /**< offset of the sequence word of a seqlock, -1 if not given */
+    bool checkStat;        /**< parse the file only if stat shows it changed */
+    int deadline;          /**< read deadline in microseconds, 0 if not given */
+    bool defer;            /**< only capture the content, parse it when the values are collected */
+    double highFrequencyPeriod; /**< period of high-frequency sampling in microseconds, 0 if not
+                                   given */
 };
 
 /**
@@ -95,16 +380,92 @@ struct foundValue
 
 static struct varParams* getVarParamsForId(int32_t desiredId);
 static int initializeLoggingFor(struct fileParams* fileSpec, struct varParams* varSpec);
-static void processLine(struct fileParams* fileSpec, int* varParamsIndex, int curLineNumber,
-                        struct Vector* foundValuesVec, char* myLine, bool verbose);
-static void tryAppendingValueToFoundValuesVec(struct fileParams* fileSpec,
-                                              struct varParams* varSpec,
-                                              struct Vector* foundValuesVec, char* foundStr);
+static void processLine(struct fileParams* fileSpec, const struct textColumns* columns,
+                        int* varParamsIndex, int curLineNumber, struct Vector* foundValuesVec,
+                        char* myLine, bool verbose);
 static int tryInsertingFileParams(struct fileParams* fileSpec);
-static int tryInsertingVarParamsSorted(struct fileParams* fileSpec, struct varParams* varSpec);
+static void freeVarParams(struct varParams* varSpec);
+static int tryIndexingVarParams(struct fileParams* fileSpec, struct varParams* varSpec);
+static char* allocFileIdentity(const char* filename);
+static void sortVarParams(struct fileParams* fileSpec);
+static struct textColumns* allocTextColumns(int count);
+static void fillTextColumns(struct textColumns* columns, struct Vector* definitions);
+static struct binaryColumns* allocBinaryColumns(int count);
+static void fillBinaryColumns(struct binaryColumns* columns, struct Vector* definitions);
+static void* takeColumn(char** cursor, int count, size_t elementSize);
+static size_t columnLength(int count, size_t elementSize);
+static void freeColumns(struct fileParams* fileSpec);
+static int compareVarParamsByRow(const void* first, const void* second);
+static int compareVarParamsByOffset(const void* first, const void* second);
 static struct Vector* parseWholeFile(struct fileParams* fileSpec, bool verbose);
 static FILE* prepareFileDescriptorForParsing(struct fileParams* fileSpec);
+static FILE* openFileDescriptor(struct fileParams* fileSpec);
+static void prefetchDueFiles(struct Vector* fileSpecVec);
+static void postDeadlineReads(struct Vector* fileSpecVec);
+static int awaitDeadlineRead(struct fileParams* fileSpec, uint64_t cycleStart);
+static int planBinaryRanges(struct fileParams* fileSpec);
+static void readBinaryRanges(struct fileParams* fileSpec);
+static void extractBinaryValues(struct fileParams* fileSpec, struct Vector* foundValuesVec);
+static int mapFile(struct fileParams* fileSpec);
+static void copyBinaryRangesFromMapping(struct fileParams* fileSpec);
+static Fileparser_Sample_Change sampleFile(struct fileParams* fileSpec);
+static uint64_t readTimestamp(struct fileParams* fileSpec);
+static bool isDeferred(struct fileParams* fileSpec);
+static Fileparser_Sample_Change captureSnapshot(struct fileParams* fileSpec);
+static int readWholeContent(struct fileParams* fileSpec);
+static void extractDeferredSnapshots(void);
+static void* parseSnapshotsWorker(void* argument);
+static struct Vector* parseSnapshot(struct fileParams* fileSpec, const char* content,
+                                    uint64_t length);
+static void adaptPeriod(struct fileParams* fileSpec, Fileparser_Sample_Change change, uint64_t now);
+static uint64_t monotonicNanoseconds(void);
+static void calibrateClock(uint64_t monotonic);
+static uint64_t wtimeAt(uint64_t monotonic);
+static void noteRead(struct fileParams* fileSpec, uint64_t readStart, uint64_t readEnd);
+static int setupEventLoop(void);
+static void setupFileNotification(struct fileParams* fileSpec);
+static bool fileChangedSinceLastRead(struct fileParams* fileSpec);
+static void invalidateLastStat(struct fileParams* fileSpec);
+static void appendLastValues(struct fileParams* fileSpec);
+static void mergeFileOptions(struct fileParams* existingFileSpec, struct fileParams* fileSpec);
+static bool waitForNextCycle(struct Vector* fileSpecVec);
+static void processInotifyEvents(struct Vector* fileSpecVec);
+static bool parseKeywordOption(char* token, struct keywordOptions* options);
+static int expandBinaryArray(struct fileParams* fileSpec, struct varParams* head,
+                             struct keywordOptions* keywords);
+static char* allocIndexedName(const char* name, int index);
+static int expandTextRow(struct fileParams* fileSpec, struct varParams* head, int firstCol,
+                         int lastCol);
+static int findNumericColumns(struct varParams* varSpec, const char* filename, int* firstCol,
+                              int* lastCol, bool** isNumeric);
+static void tryAppendingParsedValueToFoundValuesVec(struct fileParams* fileSpec,
+                                                    struct varParams* varSpec,
+                                                    struct Vector* foundValuesVec, uint64_t value);
 static struct fileParams* parseVariableSpecification(char* specStr, int idToBeAssigned);
+static bool isSelfMetricSpecification(const char* specStr);
+static SCOREP_Metric_Plugin_MetricProperties* registerSelfMetric(char* specStr);
+static void recordSelfMetrics(uint64_t cycleStart);
+static bool isDerivedMetricSpecification(const char* specStr);
+static SCOREP_Metric_Plugin_MetricProperties* registerDerivedMetric(char* specStr);
+static int compileDerivedMetric(struct varParams* varSpec, bool verbose);
+static int resolveDerivedName(const char* name, void* context, const void** matches,
+                              int capacity);
+static bool derivedSourceValue(const void* source, double* value);
+static bool isDeferredSource(const struct varParams* varSpec);
+static void evaluateDerivedMetrics(void);
+static void scheduleHighFrequencyFile(struct fileParams* fileSpec);
+static void* highFrequencyLoggingThread(void* ignoredArgument);
+static void waitUntil(uint64_t due);
+static void sampleHighFrequencyFile(struct fileParams* fileSpec, uint64_t readStart);
+static void reportHighFrequencyPeriods(void);
+static void reportDecimation(void);
+static uint64_t valueFromDouble(double value, SCOREP_MetricValueType datatype);
+static uint64_t residentSampleMemory(void);
+static int parseMemorySize(const char* sizeStr, uint64_t* bytes);
+static void openSampleLog(const char* pathTemplate);
+static void appendToSampleLog(struct varParams* varSpec, uint64_t previousChanges);
+static void commitSampleLog(void);
+static const char* selfMetricUnit(Fileparser_Self_Metric selfMetric);
 static SCOREP_MetricValueType parseDatatype(char* curDatatypeName, int* inputHex, int* inputBinary,
                                             Fileparser_Binary_Datatype* binaryDatatype);
 static int32_t init();
@@ -123,14 +484,58 @@ static int calls_to_event_info = 0;
 static int successfull_logging_additions = 0;
 static int calls_to_get_all_values = 0;
 static struct Vector* fileParamsVector = NULL;
+static struct HashMap* fileParamsByName = NULL;
+static struct HashMap* fileParamsByIdentity = NULL;
+static struct HashMap* varParamsByName = NULL;
+static struct Vector* varParamsById = NULL;
 static volatile int logging_enabled;
 static pthread_t logging_thread;
 static uint64_t (*wtime)(void) = NULL;
 static int sleep_duration = 100000;
 static pthread_mutex_t logging_mutex = PTHREAD_MUTEX_INITIALIZER;
 static char* readBuf = NULL;
-static char* binaryBytesForParsing;
 static struct Vector* unitStrPtrVec = NULL;
+static bool useBatchRead = true;
+static struct batch_read_request* batchRequests = NULL;
+static struct fileParams** batchRequestFiles = NULL;
+static int batchRequestsReserve = 0;
+static int notifyEpollFd = -1;
+static int notifyTimerFd = -1;
+static int notifyInotifyFd = -1;
+static int adaptiveTimerFd = -1;
+static struct Vector* selfMetricsVector = NULL;
+static struct Vector* derivedMetricsVector = NULL;
+/** length of varParamsById when the expressions of the derived metrics were last compiled */
+static int derivedCompiledLength = 0;
+static uint64_t cycleBytesRead = 0;
+static uint64_t cycleSamples = 0;
+static uint64_t overrunCount = 0;
+static uint64_t deadlineMissCount = 0;
+static uint64_t cycleReadLatency = 0;
+/** count of bytes allocated for the captured contents of all deferred files */
+static uint64_t snapshotMemory = 0;
+/** CLOCK_MONOTONIC time in ns and wtime of the first and the latest calibration of the clocks */
+static uint64_t calibrationFirstMonotonic = 0;
+static uint64_t calibrationFirstWtime = 0;
+static uint64_t calibrationMonotonic = 0;
+static uint64_t calibrationWtime = 0;
+/** wtime ticks per ns, 0 while it is not known yet */
+static double calibrationRate = 0;
+/** serializes the parses of the snapshots of deferred files */
+static pthread_mutex_t deferred_mutex = PTHREAD_MUTEX_INITIALIZER;
+/** count of threads parsing the snapshots of deferred files */
+static int deferThreadCount = 1;
+/** guards the files read by the high-frequency sampling thread, which never takes logging_mutex,
+ * nested within logging_mutex by everyone else */
+static pthread_mutex_t high_frequency_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_t high_frequency_thread;
+static bool highFrequencyThreadStarted = false;
+/** the files read by the high-frequency sampling thread */
+static struct Vector* highFrequencyFiles = NULL;
+/** the log the samples are written to as they are taken, NULL if there is none */
+static struct sample_log* sampleLog = NULL;
+static struct deadline_read_range* deadlineRanges = NULL;
+static int deadlineRangesReserve = 0;
 
 /**
  * Takes two pointers to define a substring in a char sequence which it copies into newly allocated
@@ -168,8 +573,25 @@ static int32_t init()
     logging_enabled = 1;
     logging_thread = 0;
 
+    /* the long-lived state of the plugin is kept in an arena of its own, apart from the heap of the
+     * application */
+    uint64_t arenaSize = ARENA_DEFAULT_SIZE;
+    char* from_env = getenv("SCOREP_METRIC_FILEPARSER_PLUGIN_ARENA_SIZE");
+    if (NULL != from_env && parseMemorySize(from_env, &arenaSize))
+    {
+        log_error_string("Ignoring malformed SCOREP_METRIC_FILEPARSER_PLUGIN_ARENA_SIZE \"%s\"",
+                         from_env);
+        arenaSize = ARENA_DEFAULT_SIZE;
+    }
+    from_env = getenv("SCOREP_METRIC_FILEPARSER_PLUGIN_HUGEPAGES");
+    bool hugePages = (NULL != from_env && 0 != atoi(from_env));
+    if (0 < arenaSize && arena_open(arenaSize, hugePages))
+    {
+        log_error("Could not map the arena for the state of the plugin, using the heap instead.");
+    }
+
     /* check whether a logging interval is set */
-    char* from_env = getenv("SCOREP_METRIC_FILEPARSER_PLUGIN_PERIOD");
+    from_env = getenv("SCOREP_METRIC_FILEPARSER_PLUGIN_PERIOD");
     if (NULL != from_env)
     {
         sleep_duration = atoi(from_env);
@@ -178,12 +600,115 @@ static int32_t init()
             sleep_duration = 100000;
         }
     }
+    /* check whether batched reads via io_uring have been disabled */
+    from_env = getenv("SCOREP_METRIC_FILEPARSER_PLUGIN_IO_URING");
+    if (NULL != from_env)
+    {
+        useBatchRead = (0 != atoi(from_env));
+    }
+    /* check where and how the sampler thread is to be scheduled */
+    if (samplerplacement_read_env())
+    {
+        log_error("Could not parse the placement of the sampler thread, ignoring the malformed "
+                  "settings.");
+    }
+    char placementDescription[256];
+    samplerplacement_describe(placementDescription, sizeof(placementDescription));
+    log_error_string("Sampler thread placement: %s", placementDescription);
+    /* check whether values beyond the memory budget are spilled or decimated */
+    Blob_Budget_Policy budgetPolicy = BLOB_BUDGET_SPILL;
+    from_env = getenv("SCOREP_METRIC_FILEPARSER_PLUGIN_BUDGET_POLICY");
+    if (NULL != from_env && 0 == strcmp(from_env, "decimate"))
+    {
+        budgetPolicy = BLOB_BUDGET_DECIMATE;
+    }
+    else if (NULL != from_env && 0 != strcmp(from_env, "spill"))
+    {
+        log_error_string("Ignoring unknown SCOREP_METRIC_FILEPARSER_PLUGIN_BUDGET_POLICY \"%s\"",
+                         from_env);
+    }
+    blobarray_set_budget_policy(budgetPolicy);
+    /* check whether the memory for the logged values is limited */
+    from_env = getenv("SCOREP_METRIC_FILEPARSER_PLUGIN_MEMORY_BUDGET");
+    if (NULL != from_env)
+    {
+        uint64_t memoryBudget = 0;
+        char* spillDirectory = getenv("TMPDIR");
+        if (NULL == spillDirectory || '\0' == spillDirectory[0])
+        {
+            spillDirectory = "/tmp";
+        }
+        if (parseMemorySize(from_env, &memoryBudget))
+        {
+            log_error_string("Ignoring malformed SCOREP_METRIC_FILEPARSER_PLUGIN_MEMORY_BUDGET "
+                             "\"%s\"",
+                             from_env);
+        }
+        else if (0 < memoryBudget && BLOB_BUDGET_SPILL == budgetPolicy &&
+                 spillfile_open(spillDirectory))
+        {
+            log_error_string("Could not create a scratch file in %s, the memory for the logged "
+                             "values is not limited.",
+                             spillDirectory);
+        }
+        else
+        {
+            /* arrays are spilled or decimated once they hold as many values as a fresh one */
+            blobarray_set_memory_budget(memoryBudget, BLOBARRAY_INIT_BUF);
+        }
+    }
+    /* check how many threads parse the contents captured from deferred files */
+    from_env = getenv("SCOREP_METRIC_FILEPARSER_PLUGIN_DEFER_THREADS");
+    if (NULL != from_env)
+    {
+        deferThreadCount = atoi(from_env);
+        if (deferThreadCount < 1)
+        {
+            deferThreadCount = 1;
+        }
+    }
+    /* check whether the samples shall also be written to a log that survives a crash */
+    from_env = getenv("SCOREP_METRIC_FILEPARSER_PLUGIN_LOG");
+    if (NULL != from_env && '\0' != from_env[0])
+    {
+        openSampleLog(from_env);
+    }
     /* storage of the given variables */
     fileParamsVector = vec_create(4);
     if (NULL == fileParamsVector)
     {
         return 1;
     }
+    /* storage of the metrics of the plugin itself */
+    selfMetricsVector = vec_create(1);
+    if (NULL == selfMetricsVector)
+    {
+        return 1;
+    }
+    /* storage of the metrics computed from other metrics */
+    derivedMetricsVector = vec_create(1);
+    if (NULL == derivedMetricsVector)
+    {
+        return 1;
+    }
+    /* the files read by the high-frequency sampling thread */
+    highFrequencyFiles = vec_create(1);
+    if (NULL == highFrequencyFiles)
+    {
+        return 1;
+    }
+    /* indices of the fileParams by their filename and identity, of the varParams by their name
+     * and id */
+    fileParamsByName = hashmap_create(4);
+    fileParamsByIdentity = hashmap_create(4);
+    varParamsByName = hashmap_create(4);
+    varParamsById = vec_create(4);
+    if (NULL == fileParamsByName || NULL == fileParamsByIdentity || NULL == varParamsByName ||
+        NULL == varParamsById)
+    {
+        log_error("Could not allocate memory for the indices of the variables.");
+        return 1;
+    }
     /* general reading buffer to temporarily store read in bytes */
     readBuf = calloc(1, DEFAULT_BUFSIZE);
     if (NULL == readBuf)
@@ -191,13 +716,6 @@ static int32_t init()
         log_error("Could not allocate readBuf for read in of the file.");
         return 1;
     }
-    /* allocate buffer for parsing byte values */
-    binaryBytesForParsing = calloc(8, sizeof(char));
-    if (NULL == binaryBytesForParsing)
-    {
-        log_error("Could not allocate 8 bytes for binaryBytesForParsing.");
-        return 1;
-    }
     /* for some odd reason we have to keep track of the bytes passed as unit description
      * to delete them after the program is through */
     unitStrPtrVec = vec_create(5);
@@ -219,6 +737,14 @@ static void fini()
         pthread_join(logging_thread, NULL);
         pthread_mutex_destroy(&logging_mutex);
     }
+    if (highFrequencyThreadStarted)
+    {
+        logging_enabled = 0;
+        pthread_join(high_frequency_thread, NULL);
+        highFrequencyThreadStarted = false;
+    }
+    reportHighFrequencyPeriods();
+    reportDecimation();
 
     /*  cleanup, i.e. use destroy and free */
     if (NULL != fileParamsVector)
@@ -229,33 +755,84 @@ static void fini()
             struct fileParams* fileSpec = fileParamsVector->data[i];
             for (int j = 0; j < fileSpec->dataDefinitions->length; ++j)
             {
-                struct varParams* varSpec = fileSpec->dataDefinitions->data[j];
-                free(varSpec->name);
-                blobarray_destroy_subelements(varSpec->logger);
-                free(varSpec->logger);
-                free(varSpec);
+                freeVarParams(fileSpec->dataDefinitions->data[j]);
             }
             vec_destroy(fileSpec->dataDefinitions);
             for (int j = 0; j < fileSpec->binaryDefinitions->length; ++j)
             {
-                struct varParams* varSpec = fileSpec->binaryDefinitions->data[j];
-                free(varSpec->name);
-                blobarray_destroy_subelements(varSpec->logger);
-                free(varSpec->logger);
-                free(varSpec);
+                freeVarParams(fileSpec->binaryDefinitions->data[j]);
             }
             vec_destroy(fileSpec->binaryDefinitions);
             free(fileSpec->filename);
+            free(fileSpec->identity);
+            deadlineread_destroy(fileSpec->reader);
             if (NULL != fileSpec->fileDescriptor)
             {
                 fclose(fileSpec->fileDescriptor);
             }
-            free(fileSpec);
+            free(fileSpec->prefetchBuf);
+            free(fileSpec->snapshots);
+            free(fileSpec->lastContent);
+            free(fileSpec->periodHistogram);
+            freeColumns(fileSpec);
+            free(fileSpec->binaryRanges);
+            free(fileSpec->binaryBuf);
+            if (NULL != fileSpec->mapping)
+            {
+                munmap(fileSpec->mapping, fileSpec->mappingLength);
+            }
+            arena_free(fileSpec);
         }
         vec_destroy(fileParamsVector);
     }
+    if (NULL != selfMetricsVector)
+    {
+        for (int i = 0; i < selfMetricsVector->length; ++i)
+        {
+            freeVarParams(selfMetricsVector->data[i]);
+        }
+        vec_destroy(selfMetricsVector);
+    }
+    if (NULL != derivedMetricsVector)
+    {
+        for (int i = 0; i < derivedMetricsVector->length; ++i)
+        {
+            freeVarParams(derivedMetricsVector->data[i]);
+        }
+        vec_destroy(derivedMetricsVector);
+        derivedCompiledLength = 0;
+    }
+    vec_destroy(highFrequencyFiles);
+    highFrequencyFiles = NULL;
+    hashmap_destroy(fileParamsByName);
+    hashmap_destroy(fileParamsByIdentity);
+    hashmap_destroy(varParamsByName);
+    vec_destroy(varParamsById);
+    if (-1 != notifyEpollFd)
+    {
+        close(notifyEpollFd);
+        close(notifyTimerFd);
+        close(adaptiveTimerFd);
+        notifyEpollFd = -1;
+        notifyTimerFd = -1;
+        adaptiveTimerFd = -1;
+    }
+    if (-1 != notifyInotifyFd)
+    {
+        close(notifyInotifyFd);
+        notifyInotifyFd = -1;
+    }
+    batchread_destroy();
+    free(batchRequests);
+    free(batchRequestFiles);
+    free(deadlineRanges);
+    deadlineRanges = NULL;
+    deadlineRangesReserve = 0;
     free(readBuf);
-    free(binaryBytesForParsing);
+    blobarray_set_memory_budget(0, 0);
+    spillfile_close();
+    samplelog_close(sampleLog);
+    sampleLog = NULL;
     /* free the strings of the units */
     if (NULL != unitStrPtrVec)
     {
@@ -265,6 +842,26 @@ static void fini()
         }
         vec_destroy(unitStrPtrVec);
     }
+    /* releases all of the state allocated from the arena at once */
+    arena_close();
+}
+
+/**
+ * Frees a varParams struct together with its logger
+ */
+static void freeVarParams(struct varParams* varSpec)
+{
+    if (NULL == varSpec)
+    {
+        return;
+    }
+    arena_free(varSpec->name);
+    blobarray_destroy_subelements(varSpec->logger);
+    arena_free(varSpec->logger);
+    arena_free(varSpec->arrayValues);
+    free(varSpec->expression);
+    derivedmetric_destroy(varSpec->derived);
+    arena_free(varSpec);
 }
 
 /**
@@ -281,6 +878,18 @@ static void set_timer(uint64_t (*timer)(void))
 static void* periodical_logging_thread(void* fileSpecVec)
 {
     struct Vector* fileParamsVector = (struct Vector *) fileSpecVec;
+    bool periodicDue = true;
+    prctl(PR_SET_NAME, SAMPLER_THREAD_NAME);
+    if (samplerplacement_apply_to_self())
+    {
+        log_error("Could not set the scheduling policy or nice value of the logging thread.");
+    }
+    /* the initial parses in add_counter are not part of the first cycle */
+    pthread_mutex_lock(&logging_mutex);
+    __atomic_store_n(&cycleBytesRead, 0, __ATOMIC_RELAXED);
+    cycleSamples = 0;
+    cycleReadLatency = 0;
+    pthread_mutex_unlock(&logging_mutex);
     while (logging_enabled)
     {
         if (NULL == wtime)
@@ -289,1091 +898,4034 @@ static void* periodical_logging_thread(void* fileSpecVec)
         }
         pthread_mutex_lock(&logging_mutex);
 
+        /* files with notifications are only read when their content changed, adaptive files when
+         * their own period elapsed */
+        uint64_t cycleStart = monotonicNanoseconds();
+        uint64_t now = cycleStart / 1000;
+        calibrateClock(cycleStart);
         for (int i = 0; i < fileParamsVector->length; ++i)
         {
-            struct Vector* foundValuesVec = parseWholeFile(fileParamsVector->data[i], false);
-            if (NULL != foundValuesVec)
+            struct fileParams* fileSpec = fileParamsVector->data[i];
+            if (0 < fileSpec->highFrequencyPeriod)
             {
-                for (int j = 0; j < foundValuesVec->length; ++j)
+                /* the file belongs to the high-frequency sampling thread, which only uses the
+                 * columns sorted here */
+                if (fileSpec->needsSorting)
                 {
-                    struct foundValue* curFound = foundValuesVec->data[j];
-                    if(curFound->associatedVarParams->doLog && NULL != curFound->associatedVarParams->logger)
-                    {
-                        if (blobarray_append(curFound->associatedVarParams->logger,
-                                             curFound->associatedValue, wtime(),
-                                             curFound->associatedVarParams->logDif,
-                                             curFound->associatedVarParams->datatype))
-                        {
-                            log_error("Ran out of memory when trying to memorize logging values.");
-                        }
-                    }
-                    free(foundValuesVec->data[j]);
+                    pthread_mutex_lock(&high_frequency_mutex);
+                    sortVarParams(fileSpec);
+                    pthread_mutex_unlock(&high_frequency_mutex);
                 }
-                vec_destroy(foundValuesVec);
+                fileSpec->isDue = false;
+                continue;
+            }
+            sortVarParams(fileSpec);
+            fileSpec->readEnd = 0;
+            if (FILEPARSER_NOTIFY_REQUESTED == fileSpec->notifyMode)
+            {
+                /* read the file once, later reads happen on notification */
+                setupFileNotification(fileSpec);
+                fileSpec->notified = true;
+            }
+            if (fileSpec->isAdaptive && setupEventLoop())
+            {
+                log_error("Could not set up a timer for adaptive periods, using fixed periods.");
+                fileSpec->isAdaptive = false;
+            }
+            if (FILEPARSER_NOTIFY_SYSFS == fileSpec->notifyMode && !fileSpec->notifyConfirmed)
+            {
+                /* not every driver calls sysfs_notify, so read it periodically until one does */
+                fileSpec->isDue = fileSpec->notified || periodicDue;
+            }
+            else if (FILEPARSER_NOTIFY_NONE != fileSpec->notifyMode)
+            {
+                fileSpec->isDue = fileSpec->notified;
+            }
+            else if (fileSpec->isAdaptive)
+            {
+                fileSpec->isDue = (now >= fileSpec->nextDue);
+            }
+            else
+            {
+                fileSpec->isDue = periodicDue;
             }
+            fileSpec->notified = false;
+            fileSpec->isUnchanged = fileSpec->isDue && fileSpec->checkStat &&
+                                    !fileChangedSinceLastRead(fileSpec);
         }
-        pthread_mutex_unlock(&logging_mutex);
-        usleep(sleep_duration);
-    }
-    return NULL;
-}
-
-/**
- * function called by Scorep to get some metadata on the measured fields
- */
-SCOREP_Metric_Plugin_MetricProperties* get_event_info(char* event_name)
-{
-    ++calls_to_event_info;
-
-    SCOREP_Metric_Plugin_MetricProperties* return_values =
-        calloc(2, sizeof(SCOREP_Metric_Plugin_MetricProperties));
-    if (NULL == return_values)
-    {
-        return NULL;
-    }
-    struct fileParams* fileSpec = parseVariableSpecification(event_name, count_of_counters);
-    struct varParams* varSpec = NULL;
-    int insertSuccessfull = 0;
-
-    if (NULL != fileSpec && 0 < fileSpec->dataDefinitions->length)
-    {
-        varSpec = (struct varParams*)(fileSpec->dataDefinitions->data[0]);
-        char* strDuplicate = strdup(varSpec->name);
-        if (NULL != strDuplicate)
+        postDeadlineReads(fileParamsVector);
+        prefetchDueFiles(fileParamsVector);
+        uint64_t earliestAdaptiveDue = UINT64_MAX;
+        for (int i = 0; i < fileParamsVector->length; ++i)
         {
-            return_values[0].name = strDuplicate;
-            strDuplicate = strdup("");
-            if (NULL != strDuplicate)
+            struct fileParams* fileSpec = fileParamsVector->data[i];
+            if (fileSpec->isDue && awaitDeadlineRead(fileSpec, cycleStart))
             {
-                return_values[0].unit = strDuplicate;
-                return_values[0].base = SCOREP_METRIC_BASE_DECIMAL;
-                return_values[0].exponent = 0;
-
-                /* tell Score-P if it supposed to draw single data points or a line graph */
-                if (1 == varSpec->logPoint)
-                {
-                    return_values[0].mode = SCOREP_METRIC_MODE_ABSOLUTE_POINT;
-                }
-                else
-                {
-                    return_values[0].mode = SCOREP_METRIC_MODE_ABSOLUTE_LAST;
-                }
-                /* tell Score-P what datatype it is receiving */
-                return_values[0].value_type = varSpec->datatype;
-
-                switch (tryInsertingFileParams(fileSpec))
+                /* the sample of this cycle is missing, the other files continue on time */
+                fileSpec->isDue = false;
+                invalidateLastStat(fileSpec);
+            }
+            if (fileSpec->isDue)
+            {
+                Fileparser_Sample_Change change = sampleFile(fileSpec);
+                if (fileSpec->isAdaptive)
                 {
-                case 2:
-                    log_error(
-                        "Could not insert variable specification to counters. Ran out of memory.");
-                    break;
-                case 1:
-                    log_error(
-                        "NULL Pointer error while inserting variable specification to counters.");
-                    break;
-                case 0:
-                    insertSuccessfull = 1;
-                    break;
-                default:
-                    log_error(
-                        "Some error appeared while inserting variable specification to counters.");
+                    adaptPeriod(fileSpec, change, now);
                 }
             }
+            if (fileSpec->isAdaptive && FILEPARSER_NOTIFY_NONE == fileSpec->notifyMode &&
+                fileSpec->nextDue < earliestAdaptiveDue)
+            {
+                earliestAdaptiveDue = fileSpec->nextDue;
+            }
         }
-        if (insertSuccessfull)
-        {
-            /* keep track of unit strings, because SCORE-P does not free them of itself */
-            vec_append(unitStrPtrVec, return_values[0].unit);
-            ++count_of_counters;
-        }
-        else
+        if (UINT64_MAX != earliestAdaptiveDue)
         {
-            if (NULL != varSpec)
+            struct itimerspec nextDue = { { 0, 0 }, { 0, 0 } };
+            nextDue.it_value.tv_sec = earliestAdaptiveDue / 1000000;
+            nextDue.it_value.tv_nsec = (earliestAdaptiveDue % 1000000) * 1000;
+            if (0 == nextDue.it_value.tv_sec && 0 == nextDue.it_value.tv_nsec)
             {
-                free(varSpec->name);
-                free(varSpec);
+                /* a zero it_value disarms the timer */
+                nextDue.it_value.tv_nsec = 1;
             }
-            vec_destroy(fileSpec->dataDefinitions);
-            vec_destroy(fileSpec->binaryDefinitions);
-            free(fileSpec->filename);
-            free(fileSpec);
-            free(return_values[0].name);
-            free(return_values[0].unit);
-            return_values[0].name = NULL;
-            return_values[0].unit = NULL;
+            timerfd_settime(adaptiveTimerFd, TFD_TIMER_ABSTIME, &nextDue, NULL);
         }
+        /* derived metrics see the metrics of the plugin itself of the same cycle, whose
+         * cycle_duration thus leaves out their evaluation */
+        recordSelfMetrics(cycleStart);
+        evaluateDerivedMetrics();
+        commitSampleLog();
+        pthread_mutex_unlock(&logging_mutex);
+        periodicDue = waitForNextCycle(fileParamsVector);
     }
-    else
-    {
-        log_error_string("Could not parse variable specification \"%s\". Syntax incorrect?",
-                         event_name);
-    }
-
-    return return_values;
+    return NULL;
 }
+
 /**
- * Tries to insert a fileParams's first varParams struct into the vector of the counters
+ * Adds a file to the ones read by the high-frequency sampling thread, which is started for the
+ * first one. The caller holds high_frequency_mutex.
  */
-static int tryInsertingFileParams(struct fileParams* fileSpec)
+static void scheduleHighFrequencyFile(struct fileParams* fileSpec)
 {
-    if (NULL == fileSpec)
+    if (fileSpec->highFrequencyScheduled)
     {
-        return 1;
+        return;
     }
-    int wasInserted = 0;
-    /* run through the vector of registered fileParams*/
-    for (int i = 0; i < fileParamsVector->length; ++i)
+    fileSpec->periodHistogram = periodhistogram_create(fileSpec->highFrequencyPeriod);
+    if (NULL == fileSpec->periodHistogram || vec_append(highFrequencyFiles, fileSpec))
     {
-        struct fileParams* curFileParams = (struct fileParams*)fileParamsVector->data[i];
-        int returnValue = 0;
-        /* check if the current fileParams match the new fileParams */
-        if (0 == strcmp(curFileParams->filename, fileSpec->filename))
-        {
-            /* try inserting the varSpec */
-            returnValue =
-                tryInsertingVarParamsSorted(curFileParams, fileSpec->dataDefinitions->data[0]);
-            vec_destroy(fileSpec->dataDefinitions);
-            vec_destroy(fileSpec->binaryDefinitions);
-            free(fileSpec->filename);
-            free(fileSpec);
-            wasInserted = 1;
-            return returnValue;
-        }
+        log_error("Ran out of memory when trying to schedule a file for high-frequency sampling.");
+        free(fileSpec->periodHistogram);
+        fileSpec->periodHistogram = NULL;
+        /* the sampler reads the file at its own period instead */
+        fileSpec->highFrequencyPeriod = 0;
+        return;
+    }
+    fileSpec->highFrequencyScheduled = true;
+    if (highFrequencyThreadStarted)
+    {
+        return;
     }
-    if (!wasInserted)
+    char placementDescription[256];
+    samplerplacement_describe_high_frequency(placementDescription, sizeof(placementDescription));
+    log_error_string("High-frequency sampling thread placement: %s", placementDescription);
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    if (samplerplacement_set_high_frequency_attr(&attr) ||
+        pthread_create(&high_frequency_thread, &attr, &highFrequencyLoggingThread, NULL))
     {
-        int returnValue = vec_append(fileParamsVector, fileSpec);
-        if (0 < ((struct varParams*)fileSpec->dataDefinitions->data[0])->inputBinaryWidth)
+        log_error("Can't start the high-frequency sampling thread at its placement, using the "
+                  "default one.");
+        if (pthread_create(&high_frequency_thread, NULL, &highFrequencyLoggingThread, NULL))
         {
-            struct varParams* varSpec = fileSpec->dataDefinitions->data[0];
-            fileSpec->dataDefinitions->data[0] = NULL;
-            fileSpec->dataDefinitions->length = 0;
-            if (vec_append(fileSpec->binaryDefinitions, varSpec))
-            {
-                vec_destroy(fileSpec->dataDefinitions);
-                vec_destroy(fileSpec->binaryDefinitions);
-                free(fileSpec->filename);
-                free(fileSpec);
-                return 3;
-            }
+            log_error("Can't start the high-frequency sampling thread.");
+            pthread_attr_destroy(&attr);
+            return;
         }
-        return returnValue;
     }
-    return 4; /* never reached, but written to make compiler happy */
+    pthread_attr_destroy(&attr);
+    highFrequencyThreadStarted = true;
 }
+
 /**
- * Tries to insert a varParams struct into a fileParams's vector in a sorted manner
+ * Thread reading the files with a period below what sleeping allows. It reads the file due next as
+ * soon as its time comes, spinning on CLOCK_MONOTONIC rather than sleeping, and takes only
+ * high_frequency_mutex, so the sampler cannot delay it.
  */
-static int tryInsertingVarParamsSorted(struct fileParams* fileSpec, struct varParams* varSpec)
+static void* highFrequencyLoggingThread(void* ignoredArgument)
 {
-    if (NULL == fileSpec || NULL == varSpec)
-    {
-        return 1;
-    }
-    if (0 < varSpec->inputBinaryWidth)
+    (void)ignoredArgument;
+    prctl(PR_SET_NAME, HIGH_FREQUENCY_THREAD_NAME);
+    while (logging_enabled)
     {
-        if (!vec_append(fileSpec->binaryDefinitions, NULL))
-        {
-            int wasInserted = 0;
-            /* run through all the elements in the vector looking for a varParams with a
-             * binaryOffset set greater than the one to be inserted,
-             * then inserts the new varParams before that */
-            for (int i = 0; i < (fileSpec->binaryDefinitions->length - 1); ++i)
-            {
-                if (((struct varParams*)fileSpec->binaryDefinitions->data[i])->binaryOffset >
-                    varSpec->binaryOffset)
-                {
-                    memmove(fileSpec->binaryDefinitions->data + i + 1,
-                            fileSpec->binaryDefinitions->data + i,
-                            sizeof(void*) * (fileSpec->binaryDefinitions->length - i - 1));
-                    fileSpec->binaryDefinitions->data[i] = varSpec;
-                    wasInserted = 1;
-                    return 0;
-                }
-            }
-            if (!wasInserted)
-            {
-                /* if no varParams was found greater than the new one, insert the new varParams at
-                 * the end of the vector */
-                fileSpec->binaryDefinitions->data[fileSpec->binaryDefinitions->length - 1] =
-                    varSpec;
-                return 0;
-            }
-        } else
+        if (NULL == wtime)
         {
-        	return 2;
+            /* Score-P sets the clock before adding counters, do not spin a whole core meanwhile */
+            usleep(sleep_duration);
+            continue;
         }
-    }
-    else
-    {
-        if (!vec_append(fileSpec->dataDefinitions, NULL))
+        /* files are only ever appended to the list, so the one found stays valid */
+        struct fileParams* nextFileSpec = NULL;
+        pthread_mutex_lock(&high_frequency_mutex);
+        for (int i = 0; i < highFrequencyFiles->length; ++i)
         {
-            int wasInserted = 0;
-            /* run through all the elements in the vector looking for a varParams with a posRow set
-             * greater than the one to be inserted, then inserts the new varParams before that */
-            for (int i = 0; i < (fileSpec->dataDefinitions->length - 1); ++i)
-            {
-                if (((struct varParams*)fileSpec->dataDefinitions->data[i])->posRow >
-                    varSpec->posRow)
-                {
-                    memmove(fileSpec->dataDefinitions->data + i + 1,
-                            fileSpec->dataDefinitions->data + i,
-                            sizeof(void*) * (fileSpec->dataDefinitions->length - i - 1));
-                    fileSpec->dataDefinitions->data[i] = varSpec;
-                    wasInserted = 1;
-                    return 0;
-                }
-            }
-            if (!wasInserted)
+            struct fileParams* fileSpec = highFrequencyFiles->data[i];
+            if (NULL == nextFileSpec || fileSpec->highFrequencyDue < nextFileSpec->highFrequencyDue)
             {
-                /* if no varParams was found greater than the new one, insert the new varParams at
-                 * the end of the vector */
-                fileSpec->dataDefinitions->data[fileSpec->dataDefinitions->length - 1] = varSpec;
-                return 0;
+                nextFileSpec = fileSpec;
             }
         }
-        else
+        uint64_t due = (NULL != nextFileSpec) ? nextFileSpec->highFrequencyDue : 0;
+        pthread_mutex_unlock(&high_frequency_mutex);
+        if (NULL == nextFileSpec)
         {
-            return 2;
+            continue;
         }
+        waitUntil(due);
+        uint64_t readStart = monotonicNanoseconds();
+        pthread_mutex_lock(&high_frequency_mutex);
+        sampleHighFrequencyFile(nextFileSpec, readStart);
+        pthread_mutex_unlock(&high_frequency_mutex);
     }
-    return 3; /* will never be reached. But written to make compiler happy */
+    return NULL;
 }
 
 /**
- * is called after get_event_info to add the counters (which I do in get_event_info) in here it
- * initializes the logging containers
+ * Lets the CPU know that the calling thread spins, which saves power and frees resources for a
+ * sibling hyperthread
  */
-static int32_t add_counter(char* event_name)
+static inline void cpuRelax(void)
 {
-    /* run through all the fileParams, scanning the files for an initialization value */
-    //DONE: with each call of add_counter find the corresponding, registered metric, and start the logging for it
-    int matchingId = -1;
-    struct fileParams* matchingFileSpec = NULL;
-    for (int i = 0; (i < fileParamsVector->length && NULL == matchingFileSpec); ++i)
-    {
-    	struct fileParams* curFileSpec = fileParamsVector->data[i];
-    	for(int j = 0; (j < curFileSpec->dataDefinitions->length && NULL == matchingFileSpec); ++j) {
-    		struct varParams* curVarSpec = (struct varParams*) curFileSpec->dataDefinitions->data[j];
-    	    if(0 == strcmp(curVarSpec->name, event_name))
-    	    {
-    	    	if(!initializeLoggingFor(curFileSpec, curVarSpec))
-    	    	{
-        	        matchingFileSpec = curFileSpec;
-        	        matchingId = curVarSpec->id;
-    	    	}
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+}
 
-    	    }
-        }
-    	for(int j = 0; (j < curFileSpec->binaryDefinitions->length && NULL == matchingFileSpec); ++j) {
-    		struct varParams* curVarSpec = (struct varParams*) curFileSpec->binaryDefinitions->data[j];
-    	    if(0 == strcmp(curVarSpec->name, event_name))
-    	    {
-    	    	if(!initializeLoggingFor(curFileSpec, curVarSpec))
-    	    	{
-        	        matchingFileSpec = curFileSpec;
-        	        matchingId = curVarSpec->id;
-    	    	}
-    	    }
-        }
+/**
+ * Returns at the CLOCK_MONOTONIC time due in ns. Sleeps overshoot by tens of microseconds, so only
+ * waits longer than HIGH_FREQUENCY_SPIN_NS sleep, and only until that long before due.
+ */
+static void waitUntil(uint64_t due)
+{
+    uint64_t now = monotonicNanoseconds();
+    if (due > now + HIGH_FREQUENCY_SPIN_NS)
+    {
+        struct timespec wakeup = { (due - HIGH_FREQUENCY_SPIN_NS) / 1000000000,
+                                   (due - HIGH_FREQUENCY_SPIN_NS) % 1000000000 };
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wakeup, NULL);
     }
-
-    if(NULL != matchingFileSpec)
+    while (monotonicNanoseconds() < due && logging_enabled)
     {
-    	++successfull_logging_additions;
-    	if(1 == successfull_logging_additions)
-    	{
-    	    /* start thread to read out the individual files periodically */
-    	    if (pthread_create(&logging_thread, NULL, &periodical_logging_thread, fileParamsVector))
-    	    {
-    	        log_error("Can't start logging thread.\n");
-    	        return -ECHILD;
-    	    }
-    	}
-   } else
-   {
-        log_error_string("Could not match up add_counter(\"%s\") with previous get_event_info", event_name);
-        return -1;
-   }
+        cpuRelax();
+    }
+}
 
-    return matchingId; // this return value defines the id with which the counter will be associated
+/**
+ * Reads a file at high frequency with pread on its descriptor kept open, parses it and appends the
+ * found values to the loggers of its varParams. The caller holds high_frequency_mutex.
+ */
+static void sampleHighFrequencyFile(struct fileParams* fileSpec, uint64_t readStart)
+{
+    if (0 != fileSpec->highFrequencyStart)
+    {
+        periodhistogram_add(fileSpec->periodHistogram, readStart - fileSpec->highFrequencyStart);
+    }
+    fileSpec->highFrequencyStart = readStart;
+    /* a read that fell behind by a whole period, e.g. as the thread was preempted, does not try to
+     * catch up, but continues the periods from now on */
+    fileSpec->highFrequencyDue += fileSpec->highFrequencyPeriod;
+    if (fileSpec->highFrequencyDue <= readStart)
+    {
+        fileSpec->highFrequencyDue = readStart + fileSpec->highFrequencyPeriod;
+    }
+    if (0 == fileSpec->isAccessible)
+    {
+        return;
+    }
+    /* the timestamp is taken from Score-P's clock directly, as the calibration belongs to the
+     * sampler */
+    uint64_t wtimeBefore = wtime();
+    bool textRead =
+        (0 < fileSpec->dataDefinitions->length && 0 == readWholeContent(fileSpec));
+    bool binaryRead =
+        (0 < fileSpec->binaryDefinitions->length && NULL != openFileDescriptor(fileSpec));
+    if (binaryRead)
+    {
+        readBinaryRanges(fileSpec);
+    }
+    uint64_t wtimeAfter = wtime();
+    uint64_t timestamp = wtimeBefore + (wtimeAfter - wtimeBefore) / 2;
+
+    struct Vector* foundValuesVec =
+        textRead ? parseSnapshot(fileSpec, fileSpec->prefetchBuf, fileSpec->prefetchLength)
+                 : vec_create(fileSpec->binaryDefinitions->length);
+    fileSpec->prefetchLength = -1;
+    if (NULL == foundValuesVec)
+    {
+        return;
+    }
+    if (binaryRead)
+    {
+        extractBinaryValues(fileSpec, foundValuesVec);
+    }
+    for (int j = 0; j < foundValuesVec->length; ++j)
+    {
+        struct foundValue* curFound = foundValuesVec->data[j];
+        struct varParams* varSpec = curFound->associatedVarParams;
+        if (varSpec->doLog && NULL != varSpec->logger)
+        {
+            uint64_t previousChanges = varSpec->logger->change_count;
+            if (blobarray_append(varSpec->logger, curFound->associatedValue, timestamp,
+                                 varSpec->logDif, varSpec->datatype))
+            {
+                log_error("Ran out of memory when trying to memorize logging values.");
+            }
+            else
+            {
+                appendToSampleLog(varSpec, previousChanges);
+            }
+        }
+        /* derived metrics read the value from the sampler */
+        __atomic_store_n(&varSpec->lastValue, curFound->associatedValue, __ATOMIC_RELAXED);
+        __atomic_store_n(&varSpec->hasLastValue, true, __ATOMIC_RELEASE);
+        free(foundValuesVec->data[j]);
+    }
+    vec_destroy(foundValuesVec);
 }
+
 /**
- * Helper function to read the first values from a fileSpec and initialize logging on the specified varSpec
+ * Reports the factor by which the values of each variable were decimated to keep the memory budget,
+ * so that the loss of resolution does not go unnoticed
  */
-static int initializeLoggingFor(struct fileParams* fileSpec, struct varParams* varSpec)
+static void reportDecimation(void)
 {
-	if (!access(fileSpec->filename, R_OK))
-	{
-		fileSpec->isAccessible = 1; //TODO: heed this flag down below in function prepareFileDescriptor!
-	}
-	else
-	{
-		log_error_string("File \"%s\" can not be accessed for reading.",
-				fileSpec->filename);
-	}
-	struct Vector* foundValuesVec = parseWholeFile(fileSpec, true);
-    bool couldInitialize = false;
-
-	if (NULL != foundValuesVec)
-	{
-		/* run through individual read outs  */
-		for (int j = 0; j < foundValuesVec->length; ++j)
-		{
-			/* try to create a new blob_holder/logging container */
-			struct foundValue* curFound = foundValuesVec->data[j];
-			if (curFound->associatedVarParams == varSpec)
-			{
-				struct blob_holder* newLoggingHolder =
-						blobarray_create(BLOBARRAY_INIT_BUF, curFound->associatedValue);
-				if (NULL != newLoggingHolder)
-				{
-					curFound->associatedVarParams->logger = newLoggingHolder;
-					couldInitialize = true;
-				}
-				else
-				{
-					log_error("Could not allocate a few bytes of memory to create a blob_holder.");
-				}
-			}
-			free(foundValuesVec->data[j]);
-		}
-		vec_destroy(foundValuesVec);
-	}
+    if (NULL == varParamsById)
+    {
+        return;
+    }
+    for (int i = 0; i < varParamsById->length; ++i)
+    {
+        struct varParams* varSpec = varParamsById->data[i];
+        if (NULL == varSpec || NULL == varSpec->logger || 1 >= varSpec->logger->decimation)
+        {
+            continue;
+        }
+        char message[512];
+        snprintf(message, sizeof(message),
+                 "The values of \"%.256s\" were decimated by a factor of %llu to keep the memory "
+                 "budget.",
+                 varSpec->name, (unsigned long long)varSpec->logger->decimation);
+        log_error(message);
+    }
+}
 
-	if(couldInitialize)
-	{
-		varSpec->doLog = true;
-		return 0;
-	} else
-	{
-		return 1;
-	}
+/**
+ * Reports the distribution of the periods achieved by the high-frequency sampling thread for each of
+ * its files
+ */
+static void reportHighFrequencyPeriods(void)
+{
+    if (NULL == highFrequencyFiles)
+    {
+        return;
+    }
+    for (int i = 0; i < highFrequencyFiles->length; ++i)
+    {
+        struct fileParams* fileSpec = highFrequencyFiles->data[i];
+        char distribution[256];
+        char message[1024];
+        periodhistogram_describe(fileSpec->periodHistogram, distribution, sizeof(distribution));
+        snprintf(message, sizeof(message),
+                 "High-frequency sampling of \"%.512s\" every %.1f us: %s", fileSpec->filename,
+                 fileSpec->highFrequencyPeriod / 1e3, distribution);
+        log_error(message);
+    }
 }
+
 /**
- * Required function for Scorep to read out the logged data
+ * Reads a file and appends the found values to the loggers of its varParams
+ *
+ * @return Returns how strongly the values changed compared to the previous read
  */
-static uint64_t get_all_values(int32_t id, SCOREP_MetricTimeValuePair** time_value_list)
+static Fileparser_Sample_Change sampleFile(struct fileParams* fileSpec)
 {
-    int saved_nr_results = 0;
-    /* try allocating memory */
-    pthread_mutex_lock(&logging_mutex);
-    if (-1 < id && id < count_of_counters)
+    Fileparser_Sample_Change change = FILEPARSER_SAMPLE_REPEATED;
+    if (isDeferred(fileSpec))
+    {
+        /* the values of a deferred file are only appended once its snapshots are parsed */
+        return fileSpec->isUnchanged ? change : captureSnapshot(fileSpec);
+    }
+    if (fileSpec->isUnchanged)
+    {
+        appendLastValues(fileSpec);
+        return change;
+    }
+    struct Vector* foundValuesVec = parseWholeFile(fileSpec, false);
+    if (NULL == foundValuesVec)
+    {
+        invalidateLastStat(fileSpec);
+        return change;
+    }
+    uint64_t timestamp = readTimestamp(fileSpec);
+    for (int j = 0; j < foundValuesVec->length; ++j)
     {
-    	struct varParams* varSpec = getVarParamsForId(id);
-    	if(NULL != varSpec && varSpec->doLog) {
-            saved_nr_results =
-                blobarray_get_TimeValuePairs(varSpec->logger, time_value_list);
-            if (0 > saved_nr_results)
+        struct foundValue* curFound = foundValuesVec->data[j];
+        struct varParams* varSpec = curFound->associatedVarParams;
+        if (varSpec->doLog && NULL != varSpec->logger)
+        {
+            uint64_t previousChanges = varSpec->logger->change_count;
+            if (blobarray_append(varSpec->logger, curFound->associatedValue, timestamp,
+                                 varSpec->logDif, varSpec->datatype))
             {
-                log_error("Could not allocate memory for passing logging data to Score-P.\n");
-                pthread_mutex_unlock(&logging_mutex);
-                return 0;
+                log_error("Ran out of memory when trying to memorize logging values.");
             }
-            blobarray_reset(varSpec->logger);
-    	}
+            else
+            {
+                ++cycleSamples;
+                appendToSampleLog(varSpec, previousChanges);
+                if (previousChanges != varSpec->logger->change_count &&
+                    FILEPARSER_SAMPLE_CHANGED_STRONGLY != change)
+                {
+                    change = FILEPARSER_SAMPLE_CHANGED;
+                    if (varSpec->hasLastValue)
+                    {
+                        double previousValue =
+                            valueAsDouble(varSpec->lastValue, varSpec->datatype);
+                        double difference =
+                            valueAsDouble(curFound->associatedValue, varSpec->datatype) -
+                            previousValue;
+                        if (fabs(difference) > fileSpec->adaptThreshold * fabs(previousValue))
+                        {
+                            change = FILEPARSER_SAMPLE_CHANGED_STRONGLY;
+                        }
+                    }
+                }
+            }
+        }
+        varSpec->lastValue = curFound->associatedValue;
+        varSpec->hasLastValue = true;
+        free(foundValuesVec->data[j]);
     }
-    pthread_mutex_unlock(&logging_mutex);
+    vec_destroy(foundValuesVec);
+    return change;
+}
 
-    ++calls_to_get_all_values;
+/**
+ * Returns the timestamp of the values of the latest read of a file. The values are attributed to
+ * the middle of the read, when the kernel most likely produced them, rather than to the end of the
+ * parse.
+ */
+static uint64_t readTimestamp(struct fileParams* fileSpec)
+{
+    if (0 == fileSpec->readEnd)
+    {
+        return wtimeAt(monotonicNanoseconds());
+    }
+    if (fileSpec->readDuration > cycleReadLatency)
+    {
+        cycleReadLatency = fileSpec->readDuration;
+    }
+    return wtimeAt(fileSpec->readStart + (fileSpec->readEnd - fileSpec->readStart) / 2);
+}
 
-    return saved_nr_results;
+/**
+ * Whether the sampler only captures the content of a file. Files holding binary values or read
+ * through a mapping are parsed right away, as their values are taken without parsing text.
+ */
+static bool isDeferred(struct fileParams* fileSpec)
+{
+    return fileSpec->defer && !fileSpec->useMmap && 0 == fileSpec->binaryDefinitions->length &&
+           0 < fileSpec->dataDefinitions->length && 0 == fileSpec->highFrequencyPeriod;
 }
 
 /**
- * Iterates over FileParamsVector to find the corresponding VarParams Data
+ * Appends the content of a file to its snapshots, unless it is identical to the content captured
+ * most recently
  */
-static struct varParams* getVarParamsForId(int32_t desiredId)
+static Fileparser_Sample_Change captureSnapshot(struct fileParams* fileSpec)
 {
-    struct varParams* desiredVarSpec = NULL;
-    for(int i = 0; (i < fileParamsVector->length && NULL == desiredVarSpec); ++i)
+    if (0 != fileSpec->isAccessible && 0 > fileSpec->prefetchLength)
     {
-    	struct fileParams* curFileSpec = (struct fileParams*) fileParamsVector->data[i];
-    	for(int j = 0; (j < curFileSpec->dataDefinitions->length && NULL == desiredVarSpec); ++j)
-    	{
-    		if(((struct varParams*)curFileSpec->dataDefinitions->data[j])->id == desiredId)
-    		{
-    			desiredVarSpec = (struct varParams*) curFileSpec->dataDefinitions->data[j];
-    		}
-    	}
-    	for(int j = 0; (j < curFileSpec->binaryDefinitions->length && NULL == desiredVarSpec); ++j)
-    	{
-    		if(((struct varParams*)curFileSpec->binaryDefinitions->data[j])->id == desiredId)
-    		{
-    			desiredVarSpec = (struct varParams*) curFileSpec->binaryDefinitions->data[j];
-    		}
-    	}
+        uint64_t readStart = monotonicNanoseconds();
+        if (0 == readWholeContent(fileSpec))
+        {
+            noteRead(fileSpec, readStart, monotonicNanoseconds());
+        }
     }
-
-    return desiredVarSpec;
+    if (0 == fileSpec->isAccessible || 0 > fileSpec->prefetchLength)
+    {
+        fileSpec->prefetchLength = -1;
+        invalidateLastStat(fileSpec);
+        return FILEPARSER_SAMPLE_REPEATED;
+    }
+    size_t length = fileSpec->prefetchLength;
+    fileSpec->prefetchLength = -1;
+    uint64_t timestamp = readTimestamp(fileSpec);
+    if ((ssize_t)length == fileSpec->lastContentLength &&
+        0 == memcmp(fileSpec->prefetchBuf, fileSpec->lastContent, length))
+    {
+        return FILEPARSER_SAMPLE_REPEATED;
+    }
+    size_t required = fileSpec->snapshotsLength + sizeof(struct snapshotHeader) +
+                      ((length + 7) & ~(size_t)7);
+    if (required > fileSpec->snapshotsReserve)
+    {
+        size_t newReserve = (0 < fileSpec->snapshotsReserve) ? fileSpec->snapshotsReserve : 4096;
+        while (newReserve < required)
+        {
+            newReserve *= 2;
+        }
+        char* reallocSnapshots = realloc(fileSpec->snapshots, newReserve);
+        if (NULL == reallocSnapshots)
+        {
+            log_error("Ran out of memory when trying to capture the content of a file.");
+            invalidateLastStat(fileSpec);
+            return FILEPARSER_SAMPLE_REPEATED;
+        }
+        fileSpec->snapshots = reallocSnapshots;
+        __atomic_add_fetch(&snapshotMemory, newReserve - fileSpec->snapshotsReserve,
+                           __ATOMIC_RELAXED);
+        fileSpec->snapshotsReserve = newReserve;
+    }
+    struct snapshotHeader header = { timestamp, length };
+    memcpy(fileSpec->snapshots + fileSpec->snapshotsLength, &header, sizeof(header));
+    memcpy(fileSpec->snapshots + fileSpec->snapshotsLength + sizeof(header),
+           fileSpec->prefetchBuf, length);
+    fileSpec->snapshotsLength = required;
+    /* the content is kept for the comparison with the next one by swapping buffers */
+    char* swapBuf = fileSpec->lastContent;
+    size_t swapReserve = fileSpec->lastContentReserve;
+    fileSpec->lastContent = fileSpec->prefetchBuf;
+    fileSpec->lastContentReserve = fileSpec->prefetchReserve;
+    fileSpec->lastContentLength = length;
+    fileSpec->prefetchBuf = swapBuf;
+    fileSpec->prefetchReserve = swapReserve;
+    return FILEPARSER_SAMPLE_CHANGED;
 }
+
 /**
- * Parses a single variable argument returning a pointer to a nice struct
- *
- * Can parse strings like these:
- * netstat:int@/proc/net/netstat+c=7;r=3s=
- * dev    :int@/proc/net/dev+c=1;r=2;d
+ * Reads the whole content of a file into its prefetchBuf with pread, growing the buffer as
+ * required
  *
- * Format:
- * name:datatype@/path/to/file+parameters
- * where datatype can be
- *  int:    int64_t
- *  uint:   uint64_t
- *  float:  double
- *  double: double
- * where parameters are
- *  c: column (number of char in the line)
- *  r: row (number of the line)
- *  s: separator (character in between data field)
- *  d: diff (only shows a diff from a starting value)
- *  p: point (show logged data as point values)
+ * @return Returns 0 on success, a value greater than that if the file could not be read
  */
-static struct fileParams* parseVariableSpecification(char* specStr, int idToBeAssigned)
+static int readWholeContent(struct fileParams* fileSpec)
 {
-    if (NULL == specStr)
+    if (NULL == openFileDescriptor(fileSpec))
     {
-        return NULL;
+        return 1;
     }
-    struct fileParams* parsedData;
-    parsedData = calloc(1, sizeof(struct fileParams));
-    if (NULL == parsedData)
+    int fd = fileno(fileSpec->fileDescriptor);
+    size_t length = 0;
+    while (true)
     {
-        log_error("Ran out of memory when trying to allocate a few bytes for a fileParams struct.");
-        return NULL;
+        if (length == fileSpec->prefetchReserve)
+        {
+            size_t newReserve = (0 < length) ? length * 2 : DEFAULT_BUFSIZE;
+            char* reallocBuf = realloc(fileSpec->prefetchBuf, newReserve);
+            if (NULL == reallocBuf)
+            {
+                return 2;
+            }
+            fileSpec->prefetchBuf = reallocBuf;
+            fileSpec->prefetchReserve = newReserve;
+        }
+        ssize_t readReturn =
+            pread(fd, fileSpec->prefetchBuf + length, fileSpec->prefetchReserve - length, length);
+        if (0 > readReturn)
+        {
+            return 3;
+        }
+        if (0 == readReturn)
+        {
+            break;
+        }
+        length += readReturn;
+        __atomic_fetch_add(&cycleBytesRead, readReturn, __ATOMIC_RELAXED);
     }
-    parsedData->dataDefinitions = vec_create(1);
-    parsedData->binaryDefinitions = vec_create(1);
+    fileSpec->prefetchLength = length;
+    return 0;
+}
 
-    if (NULL == parsedData->dataDefinitions || NULL == parsedData->binaryDefinitions)
+/**
+ * Parses the snapshots captured from all deferred files so far and appends their values to the
+ * loggers. The snapshots are taken from the sampler under the lock, but parsed without it, on
+ * SCOREP_METRIC_FILEPARSER_PLUGIN_DEFER_THREADS threads.
+ */
+static void extractDeferredSnapshots(void)
+{
+    pthread_mutex_lock(&deferred_mutex);
+    /* take the snapshots of all files */
+    int fileCount = 0;
+    size_t snapshotCount = 0;
+    pthread_mutex_lock(&logging_mutex);
+    struct fileParams** files = malloc(fileParamsVector->length * sizeof(struct fileParams*));
+    for (int i = 0; NULL != files && i < fileParamsVector->length; ++i)
     {
-        log_error_string(
-            "Could not allocate memory for vectors in struct fileParams. Input specStr was \"%s\".",
-            specStr);
-        free(parsedData);
-        vec_destroy(parsedData->dataDefinitions);
-        vec_destroy(parsedData->binaryDefinitions);
-        return NULL;
+        struct fileParams* fileSpec = fileParamsVector->data[i];
+        if (0 == fileSpec->snapshotsLength)
+        {
+            continue;
+        }
+        files[fileCount++] = fileSpec;
+        for (size_t offset = 0; offset < fileSpec->snapshotsLength; ++snapshotCount)
+        {
+            struct snapshotHeader header;
+            memcpy(&header, fileSpec->snapshots + offset, sizeof(header));
+            offset += sizeof(header) + ((header.length + 7) & ~(uint64_t)7);
+        }
     }
-
-    char* curStrOffset = NULL;
-    char* posOfCurDelim = NULL;
-
-    /* Parse variable name */
-    curStrOffset = specStr;
-    posOfCurDelim = strchr(specStr, ':');
-    char* curVarName = allocSubstring(specStr, posOfCurDelim);
-    if (NULL != posOfCurDelim)
+    if (0 == snapshotCount)
     {
-        curStrOffset = posOfCurDelim + 1;
+        pthread_mutex_unlock(&logging_mutex);
+        free(files);
+        pthread_mutex_unlock(&deferred_mutex);
+        return;
     }
-
-    /* Parse Datatype argument */
-    posOfCurDelim = strchr(curStrOffset, '@');
-    char* curDatatypeName = allocSubstring(curStrOffset, posOfCurDelim);
-    if (NULL != posOfCurDelim)
+    struct parsedSnapshot* parsed = calloc(snapshotCount, sizeof(struct parsedSnapshot));
+    char** takenSnapshots = calloc(fileCount, sizeof(char*));
+    if (NULL == parsed || NULL == takenSnapshots)
     {
-        curStrOffset = posOfCurDelim + 1;
+        pthread_mutex_unlock(&logging_mutex);
+        log_error("Could not allocate memory for parsing the captured contents of files.");
+        free(files);
+        free(parsed);
+        free(takenSnapshots);
+        pthread_mutex_unlock(&deferred_mutex);
+        return;
     }
-    int inputHex = 0;
-    int inputBinaryWidth = 0;
-    Fileparser_Binary_Datatype binaryDatatype = FILEPARSER_BINARY_DATATYPE_UNDEFINED;
-    SCOREP_MetricValueType curDatatype =
-        parseDatatype(curDatatypeName, &inputHex, &inputBinaryWidth, &binaryDatatype);
-
-    /* Parse Filename */
-    posOfCurDelim = strchr(curStrOffset, '+');
-    char* curFilename = allocSubstring(curStrOffset, posOfCurDelim);
-
-    /* variables required for parsing the position argument */
-    char* nextPosToken = NULL;
-    char* curPosToken = NULL;
-    char* posOfEqualsInPos = NULL;
-    int posRow = 0, posCol = 0, logDif = 0, logPoint = 0;
-    uint64_t binaryOffset = 0;
-    char posSep = ' ';
+    size_t parsedCount = 0;
+    for (int i = 0; i < fileCount; ++i)
+    {
+        struct fileParams* fileSpec = files[i];
+        for (size_t offset = 0; offset < fileSpec->snapshotsLength; ++parsedCount)
+        {
+            struct snapshotHeader header;
+            memcpy(&header, fileSpec->snapshots + offset, sizeof(header));
+            parsed[parsedCount].fileSpec = fileSpec;
+            parsed[parsedCount].content = fileSpec->snapshots + offset + sizeof(header);
+            parsed[parsedCount].length = header.length;
+            parsed[parsedCount].timestamp = header.timestamp;
+            offset += sizeof(header) + ((header.length + 7) & ~(uint64_t)7);
+        }
+        /* the sampler continues with empty snapshots */
+        takenSnapshots[i] = fileSpec->snapshots;
+        __atomic_sub_fetch(&snapshotMemory, fileSpec->snapshotsReserve, __ATOMIC_RELAXED);
+        fileSpec->snapshots = NULL;
+        fileSpec->snapshotsLength = 0;
+        fileSpec->snapshotsReserve = 0;
+    }
+    pthread_mutex_unlock(&logging_mutex);
 
-    /* Parse Position parameters */
-    if (NULL != posOfCurDelim)
+    /* the snapshots are independent of each other, so they are parsed by all threads at once */
+    size_t nextSnapshot = 0;
+    void* workerArguments[3] = { parsed, &snapshotCount, &nextSnapshot };
+    int threadCount = deferThreadCount;
+    if ((size_t)threadCount > snapshotCount)
     {
-        /* Tokenize position parameters using delimiter semi-colon */
-        curPosToken = strtok_r(posOfCurDelim + 1, ";", &nextPosToken);
-        while (NULL != curPosToken)
+        threadCount = snapshotCount;
+    }
+    pthread_t* threads = (1 < threadCount) ? malloc((threadCount - 1) * sizeof(pthread_t)) : NULL;
+    int startedThreads = 0;
+    for (; NULL != threads && startedThreads < threadCount - 1; ++startedThreads)
+    {
+        if (pthread_create(threads + startedThreads, NULL, parseSnapshotsWorker, workerArguments))
         {
+            break;
+        }
+    }
+    parseSnapshotsWorker(workerArguments);
+    for (int i = 0; i < startedThreads; ++i)
+    {
+        pthread_join(threads[i], NULL);
+    }
+    free(threads);
 
-            /* parse individual positional tokens */
-            posOfEqualsInPos = strchr(curPosToken, '=');
-            switch (curPosToken[0])
+    /* append the values in the order the snapshots were captured */
+    pthread_mutex_lock(&logging_mutex);
+    for (size_t i = 0; i < snapshotCount; ++i)
+    {
+        struct Vector* foundValuesVec = parsed[i].foundValuesVec;
+        for (int j = 0; NULL != foundValuesVec && j < foundValuesVec->length; ++j)
+        {
+            struct foundValue* curFound = foundValuesVec->data[j];
+            struct varParams* varSpec = curFound->associatedVarParams;
+            if (varSpec->doLog && NULL != varSpec->logger)
             {
-            case 'C': /* fall-through */
-            case 'c':
-                if (NULL != posOfEqualsInPos)
-                {
-                    posCol = atoi(posOfEqualsInPos + 1);
-                }
-                else
-                {
-                    log_error("Can't parse option C, no parameter provided.");
-                }
-                break;
-            case 'L': /* fall-through */
-            case 'l': /* fall-through */
-            case 'R': /* fall-through */
-            case 'r':
-                if (NULL != posOfEqualsInPos)
+                uint64_t previousChanges = varSpec->logger->change_count;
+                if (blobarray_append(varSpec->logger, curFound->associatedValue,
+                                     parsed[i].timestamp, varSpec->logDif, varSpec->datatype))
                 {
-                    posRow = atoi(posOfEqualsInPos + 1);
+                    log_error("Ran out of memory when trying to memorize logging values.");
                 }
                 else
                 {
-                    log_error("Can't parse option R, no parameter provided.");
+                    appendToSampleLog(varSpec, previousChanges);
                 }
-                break;
-            case 'S': /* fall-through */
-            case 's':
+            }
+            varSpec->lastValue = curFound->associatedValue;
+            varSpec->hasLastValue = true;
+            free(curFound);
+        }
+        vec_destroy(foundValuesVec);
+    }
+    pthread_mutex_unlock(&logging_mutex);
+    for (int i = 0; i < fileCount; ++i)
+    {
+        free(takenSnapshots[i]);
+    }
+    free(takenSnapshots);
+    free(parsed);
+    free(files);
+    pthread_mutex_unlock(&deferred_mutex);
+}
+
+/**
+ * Parses the snapshots of an array of parsedSnapshot until none is left, several workers share the
+ * array through an index of the next snapshot to be parsed
+ */
+static void* parseSnapshotsWorker(void* argument)
+{
+    void** arguments = argument;
+    struct parsedSnapshot* parsed = arguments[0];
+    size_t snapshotCount = *(size_t*)arguments[1];
+    size_t* nextSnapshot = arguments[2];
+    for (size_t i = __atomic_fetch_add(nextSnapshot, 1, __ATOMIC_RELAXED); i < snapshotCount;
+         i = __atomic_fetch_add(nextSnapshot, 1, __ATOMIC_RELAXED))
+    {
+        parsed[i].foundValuesVec =
+            parseSnapshot(parsed[i].fileSpec, parsed[i].content, parsed[i].length);
+    }
+    return NULL;
+}
+
+/**
+ * Parses the captured content of a text file line by line, like parseWholeFile parses the file
+ * itself, without touching any state shared with the sampler
+ *
+ * @return Returns the found values, NULL if memory could not be allocated
+ */
+static struct Vector* parseSnapshot(struct fileParams* fileSpec, const char* content,
+                                    uint64_t length)
+{
+    /* the sampler may sort the varParams of the file meanwhile, which publishes new columns */
+    const struct textColumns* columns = __atomic_load_n(&fileSpec->textColumns, __ATOMIC_ACQUIRE);
+    if (NULL == columns)
+    {
+        return vec_create(1);
+    }
+    struct Vector* foundValuesVec = vec_create(columns->count);
+    char* lines = malloc(length + 1);
+    if (NULL == foundValuesVec || NULL == lines)
+    {
+        log_error("Could not allocate memory for parsing the captured content of a file.");
+        vec_destroy(foundValuesVec);
+        free(lines);
+        return NULL;
+    }
+    memcpy(lines, content, length);
+    lines[length] = '\0';
+    int varParamsIndex = 0;
+    int curLineNumber = 0;
+    char* line = lines;
+    while (line < lines + length && varParamsIndex < columns->count)
+    {
+        char* newline = memchr(line, '\n', lines + length - line);
+        if (NULL != newline)
+        {
+            newline[0] = '\0';
+        }
+        processLine(fileSpec, columns, &varParamsIndex, curLineNumber, foundValuesVec, line,
+                    false);
+        ++curLineNumber;
+        line = (NULL != newline) ? newline + 1 : lines + length;
+    }
+    free(lines);
+    return foundValuesVec;
+}
+
+/**
+ * Checks with a single stat whether a regular file changed since it was read the last time, i.e.
+ * whether its mtime, size or inode differ. A file that was replaced, e.g. through a rename, is
+ * reopened. Files in procfs and sysfs, whose stat does not reflect their content, are always
+ * considered changed.
+ */
+static bool fileChangedSinceLastRead(struct fileParams* fileSpec)
+{
+    if (!fileSpec->hasLastStat)
+    {
+        struct statfs fsInfo;
+        if (NULL == openFileDescriptor(fileSpec) ||
+            0 != fstatfs(fileno(fileSpec->fileDescriptor), &fsInfo))
+        {
+            return true;
+        }
+        if (PROC_SUPER_MAGIC == (unsigned long)fsInfo.f_type ||
+            SYSFS_MAGIC == (unsigned long)fsInfo.f_type)
+        {
+            log_error_string("The stat of file \"%s\" does not reflect its content, ignoring "
+                             "option stat.",
+                             fileSpec->filename);
+            fileSpec->checkStat = false;
+            return true;
+        }
+    }
+    struct stat fileInfo;
+    if (0 != stat(fileSpec->filename, &fileInfo) || !S_ISREG(fileInfo.st_mode))
+    {
+        return true;
+    }
+    bool changed = !fileSpec->hasLastStat || fileInfo.st_size != fileSpec->statSize ||
+                   fileInfo.st_mtim.tv_sec != fileSpec->statModification.tv_sec ||
+                   fileInfo.st_mtim.tv_nsec != fileSpec->statModification.tv_nsec;
+    if (fileSpec->hasLastStat &&
+        (fileInfo.st_ino != fileSpec->statInode || fileInfo.st_dev != fileSpec->statDevice))
+    {
+        /* the path refers to a new file now, reopen it */
+        if (NULL != fileSpec->fileDescriptor)
+        {
+            fclose(fileSpec->fileDescriptor);
+            fileSpec->fileDescriptor = NULL;
+        }
+        /* the reader of a file with a deadline holds a descriptor of its own */
+        deadlineread_destroy(fileSpec->reader);
+        fileSpec->reader = NULL;
+        if (NULL != fileSpec->mapping)
+        {
+            munmap(fileSpec->mapping, fileSpec->mappingLength);
+            fileSpec->mapping = NULL;
+        }
+        changed = true;
+    }
+    fileSpec->hasLastStat = true;
+    fileSpec->statDevice = fileInfo.st_dev;
+    fileSpec->statInode = fileInfo.st_ino;
+    fileSpec->statSize = fileInfo.st_size;
+    fileSpec->statModification = fileInfo.st_mtim;
+    return changed;
+}
+
+/**
+ * Makes the next stat of a file count as a change, as the content matching the latest stat was not
+ * parsed, e.g. because its read missed the deadline. The inode is kept, so a file replaced
+ * meanwhile is still reopened.
+ */
+static void invalidateLastStat(struct fileParams* fileSpec)
+{
+    /* no file has a negative size */
+    fileSpec->statSize = -1;
+}
+
+/**
+ * Appends the values read most recently once more, as the file did not change. Repetition
+ * suppression of the loggers absorbs them.
+ */
+static void appendLastValues(struct fileParams* fileSpec)
+{
+    struct Vector* definitions[] = { fileSpec->dataDefinitions, fileSpec->binaryDefinitions };
+    uint64_t timestamp = wtimeAt(monotonicNanoseconds());
+    for (size_t i = 0; i < sizeof(definitions) / sizeof(definitions[0]); ++i)
+    {
+        for (int j = 0; j < definitions[i]->length; ++j)
+        {
+            struct varParams* varSpec = definitions[i]->data[j];
+            if (!varSpec->doLog || NULL == varSpec->logger || !varSpec->hasLastValue)
+            {
+                continue;
+            }
+            uint64_t previousChanges = varSpec->logger->change_count;
+            if (blobarray_append(varSpec->logger, varSpec->lastValue, timestamp, varSpec->logDif,
+                                 varSpec->datatype))
+            {
+                log_error("Ran out of memory when trying to memorize logging values.");
+            }
+            else
+            {
+                ++cycleSamples;
+                appendToSampleLog(varSpec, previousChanges);
+            }
+        }
+    }
+}
+
+/**
+ * Adapts the period of a file to the change of its values: a strong change resets it to the
+ * minimal period, while repetitions double it up to the maximal period
+ */
+static void adaptPeriod(struct fileParams* fileSpec, Fileparser_Sample_Change change, uint64_t now)
+{
+    switch (change)
+    {
+    case FILEPARSER_SAMPLE_CHANGED_STRONGLY:
+        fileSpec->curPeriod = fileSpec->minPeriod;
+        break;
+    case FILEPARSER_SAMPLE_REPEATED:
+        if (fileSpec->curPeriod < fileSpec->maxPeriod / 2)
+        {
+            fileSpec->curPeriod *= 2;
+        }
+        else
+        {
+            fileSpec->curPeriod = fileSpec->maxPeriod;
+        }
+        break;
+    case FILEPARSER_SAMPLE_CHANGED:
+        break;
+    }
+    fileSpec->nextDue = now + fileSpec->curPeriod;
+}
+
+/**
+ * Returns the time of CLOCK_MONOTONIC in nanoseconds
+ */
+static uint64_t monotonicNanoseconds(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+/**
+ * Relates CLOCK_MONOTONIC to the clock of Score-P with a single call to wtime, once per sampling
+ * cycle. The rate between both clocks is measured since the first calibration, so it gets more
+ * precise the longer the measurement runs.
+ */
+static void calibrateClock(uint64_t monotonic)
+{
+    uint64_t now = wtime();
+    if (0 == calibrationFirstMonotonic)
+    {
+        calibrationFirstMonotonic = monotonic;
+        calibrationFirstWtime = now;
+    }
+    else if (monotonic > calibrationFirstMonotonic && now >= calibrationFirstWtime)
+    {
+        calibrationRate = (double)(now - calibrationFirstWtime) /
+                          (double)(monotonic - calibrationFirstMonotonic);
+    }
+    calibrationMonotonic = monotonic;
+    calibrationWtime = now;
+}
+
+/**
+ * Converts a CLOCK_MONOTONIC time in ns to the clock of Score-P, based on the latest calibration.
+ * Until the rate between both clocks is known, wtime is asked directly.
+ */
+static uint64_t wtimeAt(uint64_t monotonic)
+{
+    if (0 == calibrationRate)
+    {
+        return wtime();
+    }
+    double offset = ((double)monotonic - (double)calibrationMonotonic) * calibrationRate;
+    if (0 > offset && (uint64_t)(-offset) > calibrationWtime)
+    {
+        return 0;
+    }
+    return calibrationWtime + (int64_t)offset;
+}
+
+/**
+ * Widens the span of the latest read of a file to cover a read from readStart to readEnd, given
+ * as CLOCK_MONOTONIC times in ns, and adds the time of the read to its duration
+ */
+static void noteRead(struct fileParams* fileSpec, uint64_t readStart, uint64_t readEnd)
+{
+    if (0 == fileSpec->readEnd)
+    {
+        fileSpec->readStart = readStart;
+        fileSpec->readEnd = readEnd;
+        fileSpec->readDuration = readEnd - readStart;
+        return;
+    }
+    fileSpec->readDuration += readEnd - readStart;
+    fileSpec->readStart = (readStart < fileSpec->readStart) ? readStart : fileSpec->readStart;
+    fileSpec->readEnd = (readEnd > fileSpec->readEnd) ? readEnd : fileSpec->readEnd;
+}
+
+/**
+ * Appends the quantities of the sampling cycle that began at cycleStart to the loggers of the
+ * metrics of the plugin itself, then resets the counters of the cycle
+ */
+static void recordSelfMetrics(uint64_t cycleStart)
+{
+    uint64_t cycleDuration = monotonicNanoseconds() - cycleStart;
+    if (cycleDuration > (uint64_t)sleep_duration * 1000)
+    {
+        ++overrunCount;
+    }
+    uint64_t timestamp = (0 < selfMetricsVector->length) ? wtimeAt(monotonicNanoseconds()) : 0;
+    for (int i = 0; i < selfMetricsVector->length; ++i)
+    {
+        struct varParams* varSpec = selfMetricsVector->data[i];
+        uint64_t value = 0;
+        switch (varSpec->selfMetric)
+        {
+        case FILEPARSER_SELF_CYCLE_DURATION:
+            value = cycleDuration;
+            break;
+        case FILEPARSER_SELF_BYTES_READ:
+            value = __atomic_load_n(&cycleBytesRead, __ATOMIC_RELAXED);
+            break;
+        case FILEPARSER_SELF_SAMPLES:
+            value = cycleSamples;
+            break;
+        case FILEPARSER_SELF_OVERRUNS:
+            value = overrunCount;
+            break;
+        case FILEPARSER_SELF_MEMORY:
+            value = residentSampleMemory();
+            break;
+        case FILEPARSER_SELF_DEADLINE_MISSES:
+            value = deadlineMissCount;
+            break;
+        case FILEPARSER_SELF_READ_LATENCY:
+            value = cycleReadLatency;
+            break;
+        case FILEPARSER_SELF_DECIMATION:
+            value = blobarray_highest_decimation();
+            break;
+        default:
+            break;
+        }
+        /* derived metrics may refer to the metrics of the plugin itself */
+        varSpec->lastValue = value;
+        varSpec->hasLastValue = true;
+        if (!varSpec->doLog || NULL == varSpec->logger)
+        {
+            continue;
+        }
+        uint64_t previousChanges = varSpec->logger->change_count;
+        if (blobarray_append(varSpec->logger, value, timestamp, 0, varSpec->datatype))
+        {
+            log_error("Ran out of memory when trying to memorize logging values.");
+        }
+        else
+        {
+            appendToSampleLog(varSpec, previousChanges);
+        }
+    }
+    /* the high-frequency sampling thread counts its bytes as well */
+    __atomic_store_n(&cycleBytesRead, 0, __ATOMIC_RELAXED);
+    cycleSamples = 0;
+    cycleReadLatency = 0;
+}
+
+/**
+ * Appends the values of the derived metrics, computed from the latest values of the metrics they
+ * refer to
+ */
+static void evaluateDerivedMetrics(void)
+{
+    if (derivedCompiledLength != varParamsById->length)
+    {
+        /* the metrics an expression refers to may be registered after it */
+        for (int i = 0; i < derivedMetricsVector->length; ++i)
+        {
+            struct varParams* varSpec = derivedMetricsVector->data[i];
+            if (NULL == varSpec->derived)
+            {
+                compileDerivedMetric(varSpec, false);
+            }
+        }
+        derivedCompiledLength = varParamsById->length;
+    }
+    uint64_t timestamp =
+        (0 < derivedMetricsVector->length) ? wtimeAt(monotonicNanoseconds()) : 0;
+    for (int i = 0; i < derivedMetricsVector->length; ++i)
+    {
+        struct varParams* varSpec = derivedMetricsVector->data[i];
+        double result = 0;
+        if (!varSpec->doLog || NULL == varSpec->logger || NULL == varSpec->derived ||
+            derivedmetric_evaluate(varSpec->derived, &derivedSourceValue, &result) ||
+            !isfinite(result))
+        {
+            continue;
+        }
+        uint64_t value = valueFromDouble(result, varSpec->datatype);
+        uint64_t previousChanges = varSpec->logger->change_count;
+        if (blobarray_append(varSpec->logger, value, timestamp, 0, varSpec->datatype))
+        {
+            log_error("Ran out of memory when trying to memorize logging values.");
+        }
+        else
+        {
+            appendToSampleLog(varSpec, previousChanges);
+        }
+        /* derived metrics may refer to each other */
+        varSpec->lastValue = value;
+        varSpec->hasLastValue = true;
+    }
+}
+
+/**
+ * Returns the value read most recently for a varParams referred to by a derived metric
+ */
+static bool derivedSourceValue(const void* source, double* value)
+{
+    const struct varParams* varSpec = source;
+    /* a file may become deferred through a later variable after the expression was compiled */
+    if (isDeferredSource(varSpec))
+    {
+        return false;
+    }
+    /* values of files read at high frequency are stored by a thread of their own */
+    if (!__atomic_load_n(&varSpec->hasLastValue, __ATOMIC_ACQUIRE))
+    {
+        return false;
+    }
+    *value = valueAsDouble(__atomic_load_n(&varSpec->lastValue, __ATOMIC_RELAXED),
+                           varSpec->datatype);
+    return true;
+}
+
+/**
+ * Returns whether the values of a varParams are only parsed when Score-P collects them
+ */
+static bool isDeferredSource(const struct varParams* varSpec)
+{
+    return NULL != varSpec->fileSpec && isDeferred(varSpec->fileSpec);
+}
+
+/**
+ * Converts a double to a value of the given datatype, integers are rounded and clamped to their
+ * range
+ */
+static uint64_t valueFromDouble(double value, SCOREP_MetricValueType datatype)
+{
+    union {
+        double dbl;
+        uint64_t uint;
+        int64_t sint;
+    } u_value;
+    switch (datatype)
+    {
+    case SCOREP_METRIC_VALUE_UINT64:
+        u_value.uint = (value <= 0) ? 0
+                       : (value >= 18446744073709551616.0) ? UINT64_MAX
+                                                            : (uint64_t)(value + 0.5);
+        break;
+    case SCOREP_METRIC_VALUE_DOUBLE:
+        u_value.dbl = value;
+        break;
+    case SCOREP_METRIC_VALUE_INT64: /* fall-through */
+    default:
+        u_value.sint = (value <= -9223372036854775808.0) ? INT64_MIN
+                       : (value >= 9223372036854775808.0) ? INT64_MAX
+                                                           : (int64_t)llround(value);
+        break;
+    }
+    return u_value.uint;
+}
+
+/**
+ * Returns the count of bytes allocated for the values stored by all loggers, including the ones of
+ * the metrics of the plugin itself, from the running totals kept as they grow and shrink
+ */
+static uint64_t residentSampleMemory(void)
+{
+    /* the contents of deferred files stand in for their values until they are parsed */
+    return blobarray_memory_in_use() + __atomic_load_n(&snapshotMemory, __ATOMIC_RELAXED);
+}
+
+/**
+ * Parses a count of bytes with an optional binary suffix K, M, or G
+ *
+ * @return Returns 0 on success, a value greater than that if sizeStr is malformed
+ */
+static int parseMemorySize(const char* sizeStr, uint64_t* bytes)
+{
+    char* end = NULL;
+    errno = 0;
+    unsigned long long size = strtoull(sizeStr, &end, 10);
+    if (end == sizeStr || 0 != errno || '-' == sizeStr[0])
+    {
+        return 1;
+    }
+    int shift = 0;
+    switch (*end)
+    {
+    case 'K': /* fall-through */
+    case 'k':
+        shift = 10;
+        ++end;
+        break;
+    case 'M': /* fall-through */
+    case 'm':
+        shift = 20;
+        ++end;
+        break;
+    case 'G': /* fall-through */
+    case 'g':
+        shift = 30;
+        ++end;
+        break;
+    default:
+        break;
+    }
+    if ('\0' != *end || size > (UINT64_MAX >> shift))
+    {
+        return 2;
+    }
+    *bytes = (uint64_t)size << shift;
+    return 0;
+}
+
+/**
+ * Returns the unit of a quantity of the plugin itself, an empty string for values of files
+ */
+static const char* selfMetricUnit(Fileparser_Self_Metric selfMetric)
+{
+    switch (selfMetric)
+    {
+    case FILEPARSER_SELF_CYCLE_DURATION: /* fall-through */
+    case FILEPARSER_SELF_READ_LATENCY:
+        return "s";
+    case FILEPARSER_SELF_BYTES_READ: /* fall-through */
+    case FILEPARSER_SELF_MEMORY:
+        return "B";
+    default:
+        return "";
+    }
+}
+
+/**
+ * Creates the sample log at a path in which "%p" is replaced by the process id, sized by
+ * SCOREP_METRIC_FILEPARSER_PLUGIN_LOG_SIZE
+ */
+static void openSampleLog(const char* pathTemplate)
+{
+    uint64_t logSize = SAMPLE_LOG_DEFAULT_SIZE;
+    char* from_env = getenv("SCOREP_METRIC_FILEPARSER_PLUGIN_LOG_SIZE");
+    if (NULL != from_env && parseMemorySize(from_env, &logSize))
+    {
+        log_error_string("Ignoring malformed SCOREP_METRIC_FILEPARSER_PLUGIN_LOG_SIZE \"%s\"",
+                         from_env);
+        logSize = SAMPLE_LOG_DEFAULT_SIZE;
+    }
+    char path[4096];
+    size_t pathLength = 0;
+    for (const char* c = pathTemplate; '\0' != *c && pathLength < sizeof(path) - 1; ++c)
+    {
+        if ('%' == c[0] && 'p' == c[1])
+        {
+            pathLength += snprintf(path + pathLength, sizeof(path) - pathLength, "%ld",
+                                   (long)getpid());
+            ++c;
+        }
+        else
+        {
+            path[pathLength++] = *c;
+        }
+    }
+    path[(pathLength < sizeof(path)) ? pathLength : sizeof(path) - 1] = '\0';
+    sampleLog = samplelog_open(path, logSize, SAMPLE_LOG_METRIC_CAPACITY);
+    if (NULL == sampleLog)
+    {
+        log_error_string("Could not create the sample log \"%s\".", path);
+    }
+}
+
+/**
+ * Writes the latest value of a variable to the sample log, if it was no repetition, i.e. if its
+ * logger's count of changes changed from previousChanges. The values are written even if the logger
+ * decimates them.
+ */
+static void appendToSampleLog(struct varParams* varSpec, uint64_t previousChanges)
+{
+    if (NULL != sampleLog && previousChanges != varSpec->logger->change_count &&
+        SAMPLE_LOG_METRIC_CAPACITY > varSpec->id)
+    {
+        samplelog_append(sampleLog, varSpec->id, varSpec->logger->latest.start_time,
+                         varSpec->logger->latest.value);
+    }
+}
+
+/**
+ * Publishes the samples of a cycle in the sample log together with the latest calibration of the
+ * clock of Score-P
+ */
+static void commitSampleLog(void)
+{
+    if (NULL == sampleLog)
+    {
+        return;
+    }
+    if (0 < calibrationRate)
+    {
+        struct timespec realtime;
+        clock_gettime(CLOCK_REALTIME, &realtime);
+        uint64_t realtimeNow = (uint64_t)realtime.tv_sec * 1000000000 + realtime.tv_nsec;
+        samplelog_set_clock(sampleLog, calibrationRate * 1e9, wtimeAt(monotonicNanoseconds()),
+                            realtimeNow);
+    }
+    samplelog_commit(sampleLog);
+}
+
+/**
+ * Sleeps until the next periodic cycle. Once a file uses notifications, this waits in epoll
+ * instead, where the periodic cycles are driven by a timerfd.
+ *
+ * @return Returns true if the periodically read files are due, false if only notified files are
+ */
+static bool waitForNextCycle(struct Vector* fileSpecVec)
+{
+    if (-1 == notifyEpollFd)
+    {
+        usleep(sleep_duration);
+        return true;
+    }
+    struct epoll_event events[NOTIFY_MAX_EVENTS];
+    bool periodicDue = false;
+    int eventCount = epoll_wait(notifyEpollFd, events, NOTIFY_MAX_EVENTS, -1);
+    for (int i = 0; i < eventCount; ++i)
+    {
+        if (&adaptiveTimerFd == events[i].data.ptr)
+        {
+            /* adaptive files check on their own whether they are due */
+            uint64_t expirations = 0;
+            if (0 > read(adaptiveTimerFd, &expirations, sizeof(expirations)) && EAGAIN != errno)
+            {
+                log_error("Could not read the expirations of the adaptive sampling timer.");
+            }
+        }
+        else if (&notifyTimerFd == events[i].data.ptr)
+        {
+            uint64_t expirations = 0;
+            if (0 > read(notifyTimerFd, &expirations, sizeof(expirations)) && EAGAIN != errno)
+            {
+                log_error("Could not read the expirations of the sampling timer.");
+            }
+            periodicDue = true;
+        }
+        else if (&notifyInotifyFd == events[i].data.ptr)
+        {
+            processInotifyEvents(fileSpecVec);
+        }
+        else
+        {
+            struct fileParams* fileSpec = events[i].data.ptr;
+            fileSpec->notified = true;
+            fileSpec->notifyConfirmed = true;
+        }
+    }
+    return periodicDue;
+}
+
+/**
+ * Sets up epoll, so the sampler can wait for notifications and timers. The periodic cycles are
+ * driven by a timerfd from then on, the adaptive cycles by a second one.
+ *
+ * @return Returns 0 on success, a value greater than that on error
+ */
+static int setupEventLoop(void)
+{
+    if (-1 != notifyEpollFd)
+    {
+        return 0;
+    }
+    notifyEpollFd = epoll_create1(EPOLL_CLOEXEC);
+    notifyTimerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    adaptiveTimerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    struct itimerspec period;
+    period.it_interval.tv_sec = sleep_duration / 1000000;
+    period.it_interval.tv_nsec = (sleep_duration % 1000000) * 1000;
+    period.it_value = period.it_interval;
+    struct epoll_event timerEvent = { .events = EPOLLIN, .data.ptr = &notifyTimerFd };
+    struct epoll_event adaptiveEvent = { .events = EPOLLIN, .data.ptr = &adaptiveTimerFd };
+    if (-1 == notifyEpollFd || -1 == notifyTimerFd || -1 == adaptiveTimerFd ||
+        0 != timerfd_settime(notifyTimerFd, 0, &period, NULL) ||
+        0 != epoll_ctl(notifyEpollFd, EPOLL_CTL_ADD, notifyTimerFd, &timerEvent) ||
+        0 != epoll_ctl(notifyEpollFd, EPOLL_CTL_ADD, adaptiveTimerFd, &adaptiveEvent))
+    {
+        int* fds[] = { &notifyEpollFd, &notifyTimerFd, &adaptiveTimerFd };
+        for (size_t i = 0; i < sizeof(fds) / sizeof(fds[0]); ++i)
+        {
+            if (-1 != *fds[i])
+            {
+                close(*fds[i]);
+                *fds[i] = -1;
+            }
+        }
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * Sets up the notification of a file: sysfs attributes are polled for POLLPRI/POLLERR, regular
+ * files are watched using inotify. Files supporting neither are read periodically. sysfs attributes
+ * are read periodically as well until their first notification arrives, as it is up to the driver
+ * whether an attribute notifies at all.
+ */
+static void setupFileNotification(struct fileParams* fileSpec)
+{
+    fileSpec->notifyMode = FILEPARSER_NOTIFY_NONE;
+    FILE* fileDescriptor = openFileDescriptor(fileSpec);
+    if (NULL == fileDescriptor)
+    {
+        return;
+    }
+    int fd = fileno(fileDescriptor);
+    struct statfs fsInfo;
+    struct stat fileInfo;
+    if (0 != fstatfs(fd, &fsInfo) || 0 != fstat(fd, &fileInfo))
+    {
+        log_error_string("Could not determine the file system of \"%s\", reading it periodically.",
+                         fileSpec->filename);
+        return;
+    }
+
+    if (setupEventLoop())
+    {
+        log_error("Could not set up epoll for file notifications, reading files periodically.");
+        return;
+    }
+
+    if (SYSFS_MAGIC == (unsigned long)fsInfo.f_type)
+    {
+        struct epoll_event fileEvent = { .events = EPOLLPRI | EPOLLERR, .data.ptr = fileSpec };
+        if (0 == epoll_ctl(notifyEpollFd, EPOLL_CTL_ADD, fd, &fileEvent))
+        {
+            fileSpec->notifyMode = FILEPARSER_NOTIFY_SYSFS;
+            return;
+        }
+    }
+    else if (PROC_SUPER_MAGIC != (unsigned long)fsInfo.f_type && S_ISREG(fileInfo.st_mode))
+    {
+        if (-1 == notifyInotifyFd)
+        {
+            notifyInotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+            struct epoll_event inotifyEvent = { .events = EPOLLIN, .data.ptr = &notifyInotifyFd };
+            if (-1 != notifyInotifyFd &&
+                0 != epoll_ctl(notifyEpollFd, EPOLL_CTL_ADD, notifyInotifyFd, &inotifyEvent))
+            {
+                close(notifyInotifyFd);
+                notifyInotifyFd = -1;
+            }
+        }
+        if (-1 != notifyInotifyFd)
+        {
+            /* watch the directory, so replacing the file through a rename is noticed as well */
+            char* directory = strdup(fileSpec->filename);
+            if (NULL != directory)
+            {
+                char* lastSlash = strrchr(directory, '/');
+                if (NULL == lastSlash)
+                {
+                    strcpy(directory, ".");
+                }
+                else
+                {
+                    lastSlash[lastSlash == directory ? 1 : 0] = '\0';
+                }
+                fileSpec->inotifyWatch = inotify_add_watch(
+                    notifyInotifyFd, directory, IN_MODIFY | IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+                free(directory);
+                if (-1 != fileSpec->inotifyWatch)
+                {
+                    fileSpec->notifyMode = FILEPARSER_NOTIFY_INOTIFY;
+                    return;
+                }
+            }
+        }
+    }
+    log_error_string("File \"%s\" does not support notifications, reading it periodically.",
+                     fileSpec->filename);
+}
+
+/**
+ * Marks the files that the pending inotify events refer to as notified
+ */
+static void processInotifyEvents(struct Vector* fileSpecVec)
+{
+    char eventBuf[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+    ssize_t readReturn;
+    while (0 < (readReturn = read(notifyInotifyFd, eventBuf, sizeof(eventBuf))))
+    {
+        for (char* curPos = eventBuf; curPos < eventBuf + readReturn;
+             curPos += sizeof(struct inotify_event) + ((struct inotify_event*)curPos)->len)
+        {
+            struct inotify_event* event = (struct inotify_event*)curPos;
+            if (0 == event->len)
+            {
+                continue;
+            }
+            for (int i = 0; i < fileSpecVec->length; ++i)
+            {
+                struct fileParams* fileSpec = fileSpecVec->data[i];
+                if (FILEPARSER_NOTIFY_INOTIFY != fileSpec->notifyMode ||
+                    event->wd != fileSpec->inotifyWatch)
+                {
+                    continue;
+                }
+                char* baseName = strrchr(fileSpec->filename, '/');
+                baseName = (NULL == baseName) ? fileSpec->filename : baseName + 1;
+                if (0 != strcmp(baseName, event->name))
+                {
+                    continue;
+                }
+                if (event->mask & (IN_MOVED_TO | IN_CREATE))
+                {
+                    /* the file was replaced, reopen it when it is read the next time */
+                    if (NULL != fileSpec->fileDescriptor)
+                    {
+                        fclose(fileSpec->fileDescriptor);
+                        fileSpec->fileDescriptor = NULL;
+                    }
+                }
+                fileSpec->notified = true;
+            }
+        }
+    }
+}
+
+/**
+ * function called by Scorep to get some metadata on the measured fields
+ *
+ * A single variable definition may define several metrics, e.g. an array of binary values, these
+ * are returned as separate entries.
+ */
+SCOREP_Metric_Plugin_MetricProperties* get_event_info(char* event_name)
+{
+    ++calls_to_event_info;
+
+    /* metrics of the plugin itself are not read from any file */
+    if (isSelfMetricSpecification(event_name))
+    {
+        return registerSelfMetric(event_name);
+    }
+    /* neither are metrics computed from other metrics */
+    if (isDerivedMetricSpecification(event_name))
+    {
+        return registerDerivedMetric(event_name);
+    }
+
+    struct fileParams* fileSpec = parseVariableSpecification(event_name, count_of_counters);
+    if (NULL == fileSpec || 0 == fileSpec->dataDefinitions->length)
+    {
+        log_error_string("Could not parse variable specification \"%s\". Syntax incorrect?",
+                         event_name);
+        return calloc(1, sizeof(SCOREP_Metric_Plugin_MetricProperties));
+    }
+    int metricCount = fileSpec->dataDefinitions->length;
+    SCOREP_Metric_Plugin_MetricProperties* return_values =
+        calloc(metricCount + 1, sizeof(SCOREP_Metric_Plugin_MetricProperties));
+    bool propertiesComplete = (NULL != return_values);
+
+    for (int i = 0; propertiesComplete && i < metricCount; ++i)
+    {
+        struct varParams* varSpec = fileSpec->dataDefinitions->data[i];
+        return_values[i].name = strdup(varSpec->name);
+        return_values[i].unit = strdup("");
+        if (NULL == return_values[i].name || NULL == return_values[i].unit)
+        {
+            propertiesComplete = false;
+            break;
+        }
+        return_values[i].base = SCOREP_METRIC_BASE_DECIMAL;
+        return_values[i].exponent = 0;
+
+        /* tell Score-P if it supposed to draw single data points or a line graph */
+        if (1 == varSpec->logPoint)
+        {
+            return_values[i].mode = SCOREP_METRIC_MODE_ABSOLUTE_POINT;
+        }
+        else
+        {
+            return_values[i].mode = SCOREP_METRIC_MODE_ABSOLUTE_LAST;
+        }
+        /* tell Score-P what datatype it is receiving */
+        return_values[i].value_type = varSpec->datatype;
+    }
+
+    int insertSuccessfull = 0;
+    if (propertiesComplete)
+    {
+        /* the logging thread may be running already */
+        pthread_mutex_lock(&logging_mutex);
+        pthread_mutex_lock(&high_frequency_mutex);
+        int insertResult = tryInsertingFileParams(fileSpec);
+        pthread_mutex_unlock(&high_frequency_mutex);
+        pthread_mutex_unlock(&logging_mutex);
+        switch (insertResult)
+        {
+        case 2:
+            log_error("Could not insert variable specification to counters. Ran out of memory.");
+            break;
+        case 1:
+            log_error("NULL Pointer error while inserting variable specification to counters.");
+            break;
+        case 0:
+            insertSuccessfull = 1;
+            break;
+        default:
+            log_error("Some error appeared while inserting variable specification to counters.");
+        }
+    }
+    if (insertSuccessfull)
+    {
+        /* keep track of unit strings, because SCORE-P does not free them of itself */
+        for (int i = 0; i < metricCount; ++i)
+        {
+            vec_append(unitStrPtrVec, return_values[i].unit);
+        }
+        count_of_counters += metricCount;
+    }
+    else
+    {
+        for (int i = 0; i < metricCount; ++i)
+        {
+            freeVarParams(fileSpec->dataDefinitions->data[i]);
+            if (NULL != return_values)
+            {
+                free(return_values[i].name);
+                free(return_values[i].unit);
+                return_values[i].name = NULL;
+                return_values[i].unit = NULL;
+            }
+        }
+        vec_destroy(fileSpec->dataDefinitions);
+        vec_destroy(fileSpec->binaryDefinitions);
+        free(fileSpec->filename);
+        free(fileSpec->identity);
+        arena_free(fileSpec);
+    }
+
+    return return_values;
+}
+/**
+ * Checks whether a variable definition describes a metric of the plugin itself, i.e. whether its
+ * datatype is "self"
+ */
+static bool isSelfMetricSpecification(const char* specStr)
+{
+    const char* posOfAt = strchr(specStr, '@');
+    const char* posOfColon = strchr(specStr, ':');
+    const char* datatypeStr =
+        (NULL != posOfColon && posOfColon < posOfAt) ? posOfColon + 1 : specStr;
+    return NULL != posOfAt && 4 == posOfAt - datatypeStr && 0 == strncmp(datatypeStr, "self", 4);
+}
+
+/**
+ * Registers a metric of the plugin itself given as [<name> ':'] 'self' '@' <quantity>, the name
+ * defaults to the whole definition
+ *
+ * @return Returns the properties of the metric, terminated by an entry without name. On error, only
+ * the terminating entry is returned.
+ */
+static SCOREP_Metric_Plugin_MetricProperties* registerSelfMetric(char* specStr)
+{
+    SCOREP_Metric_Plugin_MetricProperties* return_values =
+        calloc(2, sizeof(SCOREP_Metric_Plugin_MetricProperties));
+    if (NULL == return_values)
+    {
+        log_error("Ran out of memory when trying to allocate the properties of a metric.");
+        return NULL;
+    }
+    char* posOfAt = strchr(specStr, '@');
+    char* posOfColon = strchr(specStr, ':');
+    Fileparser_Self_Metric selfMetric = FILEPARSER_SELF_NONE;
+    for (int i = FILEPARSER_SELF_NONE + 1; i < FILEPARSER_SELF_COUNT; ++i)
+    {
+        if (0 == strcmp(posOfAt + 1, selfMetricNames[i]))
+        {
+            selfMetric = i;
+        }
+    }
+    if (FILEPARSER_SELF_NONE == selfMetric)
+    {
+        log_error_string("Unknown metric of the plugin itself \"%s\".", posOfAt + 1);
+        return return_values;
+    }
+
+    struct varParams* varSpec = arena_calloc(1, sizeof(struct varParams));
+    if (NULL == varSpec)
+    {
+        log_error("Ran out of memory when trying to allocate a few bytes for a varParams struct.");
+        return return_values;
+    }
+    varSpec->id = count_of_counters;
+    varSpec->name = (NULL != posOfColon && posOfColon < posOfAt)
+                        ? allocSubstring(specStr, posOfColon)
+                        : strdup(specStr);
+    varSpec->datatype = SCOREP_METRIC_VALUE_UINT64;
+    varSpec->selfMetric = selfMetric;
+    /* the quantities of single cycles are shown as points, the running ones as a line */
+    varSpec->logPoint = (FILEPARSER_SELF_OVERRUNS != selfMetric &&
+                         FILEPARSER_SELF_MEMORY != selfMetric &&
+                         FILEPARSER_SELF_DEADLINE_MISSES != selfMetric &&
+                         FILEPARSER_SELF_DECIMATION != selfMetric);
+    return_values[0].name = (NULL != varSpec->name) ? strdup(varSpec->name) : NULL;
+    return_values[0].unit = strdup(selfMetricUnit(selfMetric));
+    pthread_mutex_lock(&logging_mutex);
+    int insertResult = (NULL == return_values[0].name || NULL == return_values[0].unit ||
+                        vec_reserve(selfMetricsVector, selfMetricsVector->length + 1) ||
+                        tryIndexingVarParams(NULL, varSpec) ||
+                        vec_append(selfMetricsVector, varSpec));
+    pthread_mutex_unlock(&logging_mutex);
+    if (insertResult)
+    {
+        log_error("Ran out of memory when trying to register a metric of the plugin itself.");
+        free(return_values[0].name);
+        free(return_values[0].unit);
+        return_values[0].name = NULL;
+        return_values[0].unit = NULL;
+        freeVarParams(varSpec);
+        return return_values;
+    }
+    return_values[0].base = SCOREP_METRIC_BASE_DECIMAL;
+    /* cycle durations and read latencies are given in ns */
+    return_values[0].exponent = (FILEPARSER_SELF_CYCLE_DURATION == selfMetric ||
+                                 FILEPARSER_SELF_READ_LATENCY == selfMetric)
+                                    ? -9
+                                    : 0;
+    return_values[0].mode =
+        varSpec->logPoint ? SCOREP_METRIC_MODE_ABSOLUTE_POINT : SCOREP_METRIC_MODE_ABSOLUTE_LAST;
+    return_values[0].value_type = varSpec->datatype;
+    /* keep track of unit strings, because SCORE-P does not free them of itself */
+    vec_append(unitStrPtrVec, return_values[0].unit);
+    ++count_of_counters;
+    return return_values;
+}
+
+/**
+ * Checks whether a variable definition describes a derived metric, i.e. whether an expression
+ * introduced by '=' follows its '@'
+ */
+static bool isDerivedMetricSpecification(const char* specStr)
+{
+    const char* posOfAt = strchr(specStr, '@');
+    return NULL != posOfAt && '=' == posOfAt[1];
+}
+
+/**
+ * Registers a metric computed from other metrics given as [<name> ':'] <datatype> '@' '='
+ * <expression>, the name defaults to the whole definition
+ *
+ * The expression is compiled right away if all the metrics it refers to are registered already,
+ * otherwise by the logging thread once they are.
+ *
+ * @return Returns the properties of the metric, terminated by an entry without name. On error, only
+ * the terminating entry is returned.
+ */
+static SCOREP_Metric_Plugin_MetricProperties* registerDerivedMetric(char* specStr)
+{
+    SCOREP_Metric_Plugin_MetricProperties* return_values =
+        calloc(2, sizeof(SCOREP_Metric_Plugin_MetricProperties));
+    if (NULL == return_values)
+    {
+        log_error("Ran out of memory when trying to allocate the properties of a metric.");
+        return NULL;
+    }
+    char* posOfAt = strchr(specStr, '@');
+    char* posOfColon = strchr(specStr, ':');
+    bool hasName = (NULL != posOfColon && posOfColon < posOfAt);
+    char* datatypeName = allocSubstring(hasName ? posOfColon + 1 : specStr, posOfAt);
+    int inputHex = 0;
+    int inputBinaryWidth = 0;
+    Fileparser_Binary_Datatype binaryDatatype = FILEPARSER_BINARY_DATATYPE_UNDEFINED;
+    SCOREP_MetricValueType datatype =
+        parseDatatype(datatypeName, &inputHex, &inputBinaryWidth, &binaryDatatype);
+    if (inputHex || 0 != inputBinaryWidth)
+    {
+        log_error_string("Derived metrics are of the datatypes int, uint or double, not \"%s\".",
+                         datatypeName);
+        free(datatypeName);
+        return return_values;
+    }
+    free(datatypeName);
+
+    struct varParams* varSpec = arena_calloc(1, sizeof(struct varParams));
+    if (NULL == varSpec)
+    {
+        log_error("Ran out of memory when trying to allocate a few bytes for a varParams struct.");
+        return return_values;
+    }
+    varSpec->id = count_of_counters;
+    varSpec->name = hasName ? allocSubstring(specStr, posOfColon) : strdup(specStr);
+    varSpec->datatype = datatype;
+    varSpec->expression = strdup(posOfAt + 2);
+    return_values[0].name = (NULL != varSpec->name) ? strdup(varSpec->name) : NULL;
+    return_values[0].unit = strdup("");
+    pthread_mutex_lock(&logging_mutex);
+    int compileResult = (NULL != varSpec->name && NULL != varSpec->expression)
+                            ? compileDerivedMetric(varSpec, true)
+                            : 3;
+    /* metrics registered later on may still resolve the names of the expression */
+    int insertResult = (1 == compileResult || 3 == compileResult ||
+                        NULL == return_values[0].name || NULL == return_values[0].unit ||
+                        vec_reserve(derivedMetricsVector, derivedMetricsVector->length + 1) ||
+                        tryIndexingVarParams(NULL, varSpec) ||
+                        vec_append(derivedMetricsVector, varSpec));
+    pthread_mutex_unlock(&logging_mutex);
+    if (insertResult)
+    {
+        if (1 != compileResult)
+        {
+            log_error("Ran out of memory when trying to register a derived metric.");
+        }
+        free(return_values[0].name);
+        free(return_values[0].unit);
+        return_values[0].name = NULL;
+        return_values[0].unit = NULL;
+        freeVarParams(varSpec);
+        return return_values;
+    }
+    return_values[0].base = SCOREP_METRIC_BASE_DECIMAL;
+    return_values[0].exponent = 0;
+    return_values[0].mode = SCOREP_METRIC_MODE_ABSOLUTE_LAST;
+    return_values[0].value_type = varSpec->datatype;
+    /* keep track of unit strings, because SCORE-P does not free them of itself */
+    vec_append(unitStrPtrVec, return_values[0].unit);
+    ++count_of_counters;
+    return return_values;
+}
+
+/**
+ * Compiles the expression of a derived metric against the metrics registered so far, the caller
+ * holds logging_mutex
+ *
+ * @param verbose whether problems are reported, names not matching any metric only as a warning
+ * @return Returns 0 on success, or the return value of derivedmetric_compile
+ */
+static int compileDerivedMetric(struct varParams* varSpec, bool verbose)
+{
+    char error[256];
+    int compileResult = derivedmetric_compile(varSpec->expression, &resolveDerivedName, varSpec,
+                                              &varSpec->derived, error, sizeof(error));
+    if (verbose && 0 != compileResult)
+    {
+        char message[512];
+        snprintf(message, sizeof(message), "Derived metric \"%s\": %s%s", varSpec->name, error,
+                 (2 == compileResult)
+                     ? ", it is computed once the metrics it refers to are registered."
+                     : ".");
+        log_error(message);
+    }
+    return compileResult;
+}
+
+/**
+ * Looks up the metrics whose names match a name of the expression of a derived metric, given as
+ * context, which never refers to itself. Variables of deferred files are refused, as their values
+ * are only known once Score-P collects them.
+ */
+static int resolveDerivedName(const char* name, void* context, const void** matches,
+                              int capacity)
+{
+    if (NULL == strchr(name, '*'))
+    {
+        struct varParams* varSpec = hashmap_get(varParamsByName, name);
+        if (NULL == varSpec || context == varSpec)
+        {
+            return 0;
+        }
+        if (isDeferredSource(varSpec))
+        {
+            return -1;
+        }
+        matches[0] = varSpec;
+        return 1;
+    }
+    int matchCount = 0;
+    for (int i = 0; i < varParamsById->length; ++i)
+    {
+        struct varParams* varSpec = varParamsById->data[i];
+        if (NULL != varSpec && context != varSpec && derivedmetric_match(name, varSpec->name))
+        {
+            if (isDeferredSource(varSpec))
+            {
+                return -1;
+            }
+            if (matchCount < capacity)
+            {
+                matches[matchCount] = varSpec;
+            }
+            ++matchCount;
+        }
+    }
+    return matchCount;
+}
+
+/**
+ * Tries to insert all the varParams structs of a freshly parsed fileParams into the counters,
+ * either into the fileParams registered for the same file or as a new fileParams
+ *
+ * Either all varParams are inserted or none of them.
+ */
+static int tryInsertingFileParams(struct fileParams* fileSpec)
+{
+    if (NULL == fileSpec)
+    {
+        return 1;
+    }
+    struct Vector* parsedDefinitions = fileSpec->dataDefinitions;
+    struct fileParams* targetFileSpec = hashmap_get(fileParamsByName, fileSpec->filename);
+    /* a file registered under another path, e.g. through a symlink in sysfs, is read only once */
+    if (NULL == targetFileSpec)
+    {
+        fileSpec->identity = allocFileIdentity(fileSpec->filename);
+        if (NULL != fileSpec->identity)
+        {
+            targetFileSpec = hashmap_get(fileParamsByIdentity, fileSpec->identity);
+        }
+    }
+
+    /* make sure inserting can not fail halfway */
+    int newCount = parsedDefinitions->length;
+    if (hashmap_reserve(varParamsByName, varParamsByName->length + newCount) ||
+        vec_reserve(varParamsById, count_of_counters + newCount))
+    {
+        return 2;
+    }
+    if (NULL == targetFileSpec)
+    {
+        /* the new fileParams starts out with empty vectors, the parsed varParams are appended */
+        struct Vector* newDefinitions = vec_create(newCount);
+        if (NULL == newDefinitions || vec_reserve(fileSpec->binaryDefinitions, newCount) ||
+            vec_reserve(fileParamsVector, fileParamsVector->length + 1) ||
+            hashmap_reserve(fileParamsByIdentity, fileParamsByIdentity->length + 1) ||
+            hashmap_put(fileParamsByName, fileSpec->filename, fileSpec))
+        {
+            vec_destroy(newDefinitions);
+            return 2;
+        }
+        if (NULL != fileSpec->identity)
+        {
+            hashmap_put(fileParamsByIdentity, fileSpec->identity, fileSpec);
+        }
+        fileSpec->dataDefinitions = newDefinitions;
+        targetFileSpec = fileSpec;
+        vec_append(fileParamsVector, fileSpec);
+    }
+    else
+    {
+        if (vec_reserve(targetFileSpec->dataDefinitions,
+                        targetFileSpec->dataDefinitions->length + newCount) ||
+            vec_reserve(targetFileSpec->binaryDefinitions,
+                        targetFileSpec->binaryDefinitions->length + newCount))
+        {
+            return 2;
+        }
+        mergeFileOptions(targetFileSpec, fileSpec);
+    }
+
+    /* the vectors are sorted once, before the file is parsed the next time */
+    for (int i = 0; i < newCount; ++i)
+    {
+        struct varParams* varSpec = parsedDefinitions->data[i];
+        if (0 < varSpec->inputBinaryWidth)
+        {
+            vec_append(targetFileSpec->binaryDefinitions, varSpec);
+        }
+        else
+        {
+            vec_append(targetFileSpec->dataDefinitions, varSpec);
+        }
+        tryIndexingVarParams(targetFileSpec, varSpec);
+    }
+    targetFileSpec->needsSorting = true;
+    targetFileSpec->hasInitialValues = false;
+    vec_destroy(parsedDefinitions);
+    if (targetFileSpec != fileSpec)
+    {
+        vec_destroy(fileSpec->binaryDefinitions);
+        free(fileSpec->filename);
+        free(fileSpec->identity);
+        arena_free(fileSpec);
+    }
+    return 0;
+}
+
+/**
+ * Describes which file a path refers to by the device and inode of the file, so that different
+ * paths to the same file can be recognized
+ *
+ * @return Returns the identity as newly allocated string, NULL if the file can not be stat'ed or
+ * its filesystem does not provide inode numbers
+ */
+static char* allocFileIdentity(const char* filename)
+{
+    struct stat fileStat;
+    if (stat(filename, &fileStat) || 0 == fileStat.st_ino)
+    {
+        return NULL;
+    }
+    char identity[64];
+    snprintf(identity, sizeof(identity), "%ju:%ju", (uintmax_t)fileStat.st_dev,
+             (uintmax_t)fileStat.st_ino);
+    return strdup(identity);
+}
+
+/**
+ * Makes a varParams findable by its name and id. Of several varParams of the same name, the one
+ * indexed first is found.
+ *
+ * @return Returns 0 on success, a value greater than that on error, which can not happen if space
+ * for the varParams was reserved in varParamsByName and varParamsById
+ */
+static int tryIndexingVarParams(struct fileParams* fileSpec, struct varParams* varSpec)
+{
+    if (vec_reserve(varParamsById, varSpec->id + 1) ||
+        (NULL == hashmap_get(varParamsByName, varSpec->name) &&
+         hashmap_put(varParamsByName, varSpec->name, varSpec)))
+    {
+        return 1;
+    }
+    varSpec->fileSpec = fileSpec;
+    while (varParamsById->length <= varSpec->id)
+    {
+        vec_append(varParamsById, NULL);
+    }
+    varParamsById->data[varSpec->id] = varSpec;
+    return 0;
+}
+
+/**
+ * Takes over the per-file options of a fileParams that is merged into an existing one, unless the
+ * existing one has set these options already
+ */
+static void mergeFileOptions(struct fileParams* existingFileSpec, struct fileParams* fileSpec)
+{
+    if (FILEPARSER_NOTIFY_NONE == existingFileSpec->notifyMode)
+    {
+        existingFileSpec->notifyMode = fileSpec->notifyMode;
+    }
+    if (!existingFileSpec->useMmap && fileSpec->useMmap)
+    {
+        existingFileSpec->useMmap = true;
+        existingFileSpec->seqlockOffset = fileSpec->seqlockOffset;
+    }
+    existingFileSpec->checkStat = existingFileSpec->checkStat || fileSpec->checkStat;
+    existingFileSpec->defer = existingFileSpec->defer || fileSpec->defer;
+    if (0 == existingFileSpec->highFrequencyPeriod)
+    {
+        existingFileSpec->highFrequencyPeriod = fileSpec->highFrequencyPeriod;
+    }
+    if (0 == existingFileSpec->deadline)
+    {
+        existingFileSpec->deadline = fileSpec->deadline;
+    }
+    if (!existingFileSpec->isAdaptive && fileSpec->isAdaptive)
+    {
+        existingFileSpec->isAdaptive = true;
+        existingFileSpec->minPeriod = fileSpec->minPeriod;
+        existingFileSpec->maxPeriod = fileSpec->maxPeriod;
+        existingFileSpec->curPeriod = fileSpec->curPeriod;
+        existingFileSpec->adaptThreshold = fileSpec->adaptThreshold;
+    }
+}
+
+/**
+ * Sorts the text varParams of a file by their row, separator and column and the binary ones by
+ * their offset, if any were appended since the last sort, and publishes their columns in the new
+ * order. varParams of the same field or offset keep the order of their ids.
+ */
+static void sortVarParams(struct fileParams* fileSpec)
+{
+    if (!fileSpec->needsSorting)
+    {
+        return;
+    }
+    /* the columns are allocated before the vectors are sorted, so that the previous columns still
+     * match the order of the vectors if memory runs out, and the next cycle tries again */
+    struct textColumns* textColumns = allocTextColumns(fileSpec->dataDefinitions->length);
+    struct binaryColumns* binaryColumns = allocBinaryColumns(fileSpec->binaryDefinitions->length);
+    if (NULL == textColumns || NULL == binaryColumns)
+    {
+        log_error("Could not allocate memory for the columns of the variables of a file.");
+        arena_free(textColumns);
+        arena_free(binaryColumns);
+        return;
+    }
+    qsort(fileSpec->dataDefinitions->data, fileSpec->dataDefinitions->length, sizeof(void*),
+          compareVarParamsByRow);
+    qsort(fileSpec->binaryDefinitions->data, fileSpec->binaryDefinitions->length, sizeof(void*),
+          compareVarParamsByOffset);
+    fillTextColumns(textColumns, fileSpec->dataDefinitions);
+    fillBinaryColumns(binaryColumns, fileSpec->binaryDefinitions);
+    textColumns->replaced = fileSpec->textColumns;
+    binaryColumns->replaced = fileSpec->binaryColumns;
+    __atomic_store_n(&fileSpec->textColumns, textColumns, __ATOMIC_RELEASE);
+    fileSpec->binaryColumns = binaryColumns;
+    fileSpec->needsSorting = false;
+}
+
+/**
+ * Returns the count of bytes of a column of count elements, rounded up to whole cache lines
+ */
+static size_t columnLength(int count, size_t elementSize)
+{
+    return (count * elementSize + CACHE_LINE_SIZE - 1) & ~(size_t)(CACHE_LINE_SIZE - 1);
+}
+
+/**
+ * Returns the column of count elements at *cursor and advances *cursor to the next cache line
+ * behind it
+ */
+static void* takeColumn(char** cursor, int count, size_t elementSize)
+{
+    void* column = *cursor;
+    *cursor += columnLength(count, elementSize);
+    return column;
+}
+
+/**
+ * Allocates the columns for count text varParams, which share a single block of memory with the
+ * struct textColumns in front of them
+ *
+ * @return Returns the columns to be released by arena_free, NULL if memory ran out
+ */
+static struct textColumns* allocTextColumns(int count)
+{
+    size_t length = columnLength(1, sizeof(struct textColumns)) +
+                    columnLength(count, sizeof(struct varParams*)) +
+                    2 * columnLength(count, sizeof(int)) + 2 * columnLength(count, sizeof(char)) +
+                    columnLength(count, sizeof(SCOREP_MetricValueType));
+    char* cursor = arena_calloc_aligned(length, CACHE_LINE_SIZE);
+    if (NULL == cursor)
+    {
+        return NULL;
+    }
+    struct textColumns* columns = takeColumn(&cursor, 1, sizeof(struct textColumns));
+    columns->count = count;
+    columns->varSpecs = takeColumn(&cursor, count, sizeof(struct varParams*));
+    columns->posRow = takeColumn(&cursor, count, sizeof(int));
+    columns->posCol = takeColumn(&cursor, count, sizeof(int));
+    columns->posSep = takeColumn(&cursor, count, sizeof(char));
+    columns->inputHex = takeColumn(&cursor, count, sizeof(char));
+    columns->datatype = takeColumn(&cursor, count, sizeof(SCOREP_MetricValueType));
+    return columns;
+}
+
+/**
+ * Copies the fields of the text varParams in definitions, as many as columns were allocated for,
+ * into the columns
+ */
+static void fillTextColumns(struct textColumns* columns, struct Vector* definitions)
+{
+    for (int i = 0; i < columns->count; ++i)
+    {
+        struct varParams* varSpec = definitions->data[i];
+        columns->varSpecs[i] = varSpec;
+        columns->posRow[i] = varSpec->posRow;
+        columns->posCol[i] = varSpec->posCol;
+        columns->posSep[i] = varSpec->posSep;
+        columns->inputHex[i] = (0 != varSpec->inputHex);
+        columns->datatype[i] = varSpec->datatype;
+    }
+}
+
+/**
+ * Allocates the columns for count binary varParams, like allocTextColumns
+ *
+ * @return Returns the columns to be released by arena_free, NULL if memory ran out
+ */
+static struct binaryColumns* allocBinaryColumns(int count)
+{
+    size_t length = columnLength(1, sizeof(struct binaryColumns)) +
+                    columnLength(count, sizeof(struct varParams*)) +
+                    columnLength(count, sizeof(uint64_t)) + columnLength(count, sizeof(int)) +
+                    columnLength(count, sizeof(Fileparser_Binary_Datatype)) +
+                    columnLength(count, sizeof(bool));
+    char* cursor = arena_calloc_aligned(length, CACHE_LINE_SIZE);
+    if (NULL == cursor)
+    {
+        return NULL;
+    }
+    struct binaryColumns* columns = takeColumn(&cursor, 1, sizeof(struct binaryColumns));
+    columns->count = count;
+    columns->varSpecs = takeColumn(&cursor, count, sizeof(struct varParams*));
+    columns->binaryOffset = takeColumn(&cursor, count, sizeof(uint64_t));
+    columns->inputBinaryWidth = takeColumn(&cursor, count, sizeof(int));
+    columns->binaryDatatype = takeColumn(&cursor, count, sizeof(Fileparser_Binary_Datatype));
+    columns->isArrayElement = takeColumn(&cursor, count, sizeof(bool));
+    return columns;
+}
+
+/**
+ * Copies the fields of the binary varParams in definitions into the columns, like fillTextColumns
+ */
+static void fillBinaryColumns(struct binaryColumns* columns, struct Vector* definitions)
+{
+    for (int i = 0; i < columns->count; ++i)
+    {
+        struct varParams* varSpec = definitions->data[i];
+        columns->varSpecs[i] = varSpec;
+        columns->binaryOffset[i] = varSpec->binaryOffset;
+        columns->inputBinaryWidth[i] = varSpec->inputBinaryWidth;
+        columns->binaryDatatype[i] = varSpec->binaryDatatype;
+        columns->isArrayElement[i] = (NULL != varSpec->arrayHead);
+    }
+}
+
+/**
+ * Releases the current columns of a file and all the ones they replaced
+ */
+static void freeColumns(struct fileParams* fileSpec)
+{
+    while (NULL != fileSpec->textColumns)
+    {
+        struct textColumns* replaced = fileSpec->textColumns->replaced;
+        arena_free(fileSpec->textColumns);
+        fileSpec->textColumns = replaced;
+    }
+    while (NULL != fileSpec->binaryColumns)
+    {
+        struct binaryColumns* replaced = fileSpec->binaryColumns->replaced;
+        arena_free(fileSpec->binaryColumns);
+        fileSpec->binaryColumns = replaced;
+    }
+}
+
+/**
+ * qsort comparator of pointers to varParams, by posRow, posSep, posCol and id
+ */
+static int compareVarParamsByRow(const void* first, const void* second)
+{
+    const struct varParams* firstVarSpec = *(struct varParams* const*)first;
+    const struct varParams* secondVarSpec = *(struct varParams* const*)second;
+    if (firstVarSpec->posRow != secondVarSpec->posRow)
+    {
+        return (firstVarSpec->posRow < secondVarSpec->posRow) ? -1 : 1;
+    }
+    if (firstVarSpec->posSep != secondVarSpec->posSep)
+    {
+        return (firstVarSpec->posSep < secondVarSpec->posSep) ? -1 : 1;
+    }
+    if (firstVarSpec->posCol != secondVarSpec->posCol)
+    {
+        return (firstVarSpec->posCol < secondVarSpec->posCol) ? -1 : 1;
+    }
+    return (firstVarSpec->id > secondVarSpec->id) - (firstVarSpec->id < secondVarSpec->id);
+}
+
+/**
+ * qsort comparator of pointers to varParams, by binaryOffset and id
+ */
+static int compareVarParamsByOffset(const void* first, const void* second)
+{
+    const struct varParams* firstVarSpec = *(struct varParams* const*)first;
+    const struct varParams* secondVarSpec = *(struct varParams* const*)second;
+    if (firstVarSpec->binaryOffset != secondVarSpec->binaryOffset)
+    {
+        return (firstVarSpec->binaryOffset < secondVarSpec->binaryOffset) ? -1 : 1;
+    }
+    return (firstVarSpec->id > secondVarSpec->id) - (firstVarSpec->id < secondVarSpec->id);
+}
+
+/**
+ * is called after get_event_info to add the counters (which I do in get_event_info) in here it
+ * initializes the logging containers
+ */
+static int32_t add_counter(char* event_name)
+{
+    /* find the corresponding, registered metric and start the logging for it */
+    int matchingId = -1;
+    pthread_mutex_lock(&logging_mutex);
+    struct varParams* varSpec = hashmap_get(varParamsByName, event_name);
+    if (NULL != varSpec && NULL != varSpec->fileSpec)
+    {
+        pthread_mutex_lock(&high_frequency_mutex);
+        if (!initializeLoggingFor(varSpec->fileSpec, varSpec))
+        {
+            matchingId = varSpec->id;
+            if (0 < varSpec->fileSpec->highFrequencyPeriod)
+            {
+                scheduleHighFrequencyFile(varSpec->fileSpec);
+            }
+        }
+        pthread_mutex_unlock(&high_frequency_mutex);
+    }
+    else if (NULL != varSpec)
+    {
+        /* metrics of the plugin itself and derived metrics have no initial value to be read */
+        varSpec->logger = blobarray_create(BLOBARRAY_INIT_BUF, 0);
+        if (NULL != varSpec->logger)
+        {
+            varSpec->doLog = true;
+            matchingId = varSpec->id;
+        }
+        else
+        {
+            log_error("Could not allocate a few bytes of memory to create a blob_holder.");
+        }
+    }
+    if (-1 != matchingId && NULL != sampleLog &&
+        samplelog_add_metric(sampleLog, matchingId, varSpec->name,
+                             selfMetricUnit(varSpec->selfMetric), varSpec->datatype))
+    {
+        log_error_string("The sample log has no room for metric \"%s\", its values are not "
+                         "logged.",
+                         event_name);
+    }
+    pthread_mutex_unlock(&logging_mutex);
+
+    if(-1 != matchingId)
+    {
+    	++successfull_logging_additions;
+    	if(1 == successfull_logging_additions)
+    	{
+    	    /* start thread to read out the individual files periodically, at its placement if
+    	     * possible, e.g. SCHED_FIFO requires privileges */
+    	    pthread_attr_t attr;
+    	    pthread_attr_init(&attr);
+    	    if (samplerplacement_set_attr(&attr) ||
+    	        pthread_create(&logging_thread, &attr, &periodical_logging_thread, fileParamsVector))
+    	    {
+    	        log_error("Can't start logging thread at its placement, using the default one.");
+    	        if (pthread_create(&logging_thread, NULL, &periodical_logging_thread,
+    	                           fileParamsVector))
+    	        {
+    	            pthread_attr_destroy(&attr);
+    	            log_error("Can't start logging thread.\n");
+    	            return -ECHILD;
+    	        }
+    	    }
+    	    pthread_attr_destroy(&attr);
+    	}
+   } else
+   {
+        log_error_string("Could not match up add_counter(\"%s\") with previous get_event_info", event_name);
+        return -1;
+   }
+
+    return matchingId; // this return value defines the id with which the counter will be associated
+}
+/**
+ * Helper function to read the first values from a fileSpec and initialize logging on the specified varSpec
+ *
+ * The file is parsed only once for the initial values of all its varParams, unless further varParams
+ * were inserted in the meantime.
+ */
+static int initializeLoggingFor(struct fileParams* fileSpec, struct varParams* varSpec)
+{
+    sortVarParams(fileSpec);
+    if (!fileSpec->hasInitialValues)
+    {
+        if (!access(fileSpec->filename, R_OK))
+        {
+            fileSpec->isAccessible = 1;
+        }
+        else
+        {
+            log_error_string("File \"%s\" can not be accessed for reading.", fileSpec->filename);
+        }
+        struct Vector* foundValuesVec = parseWholeFile(fileSpec, true);
+        if (NULL != foundValuesVec)
+        {
+            /* memorize the initial values of all the varParams read */
+            for (int j = 0; j < foundValuesVec->length; ++j)
+            {
+                struct foundValue* curFound = foundValuesVec->data[j];
+                curFound->associatedVarParams->lastValue = curFound->associatedValue;
+                curFound->associatedVarParams->hasLastValue = true;
+                free(foundValuesVec->data[j]);
+            }
+            vec_destroy(foundValuesVec);
+        }
+        fileSpec->hasInitialValues = true;
+    }
+    if (!varSpec->hasLastValue)
+    {
+        return 1;
+    }
+    if (NULL == varSpec->logger)
+    {
+        /* create a new blob_holder/logging container */
+        varSpec->logger = blobarray_create(BLOBARRAY_INIT_BUF, varSpec->lastValue);
+        if (NULL == varSpec->logger)
+        {
+            log_error("Could not allocate a few bytes of memory to create a blob_holder.");
+            return 1;
+        }
+    }
+    varSpec->doLog = true;
+    return 0;
+}
+/**
+ * Required function for Scorep to read out the logged data
+ */
+static uint64_t get_all_values(int32_t id, SCOREP_MetricTimeValuePair** time_value_list)
+{
+    int saved_nr_results = 0;
+    struct varParams* varSpec = NULL;
+    if (-1 < id && id < count_of_counters)
+    {
+        varSpec = getVarParamsForId(id);
+    }
+    if (NULL == varSpec || !varSpec->doLog)
+    {
+        ++calls_to_get_all_values;
+        return 0;
+    }
+    if (NULL != varSpec->fileSpec && varSpec->fileSpec->defer)
+    {
+        extractDeferredSnapshots();
+    }
+    /* the sampler continues logging into a fresh array, which is allocated beforehand, sized like
+     * the previous pull but within the share of the budget, so that the lock is only held for
+     * swapping arrays */
+    uint64_t spareReserved = varSpec->pulledCount + 1;
+    if (blobarray_budget_share() < spareReserved)
+    {
+        spareReserved = blobarray_budget_share();
+    }
+    if (BLOBARRAY_PULL_MIN_BUF > spareReserved)
+    {
+        spareReserved = BLOBARRAY_PULL_MIN_BUF;
+    }
+    struct measurement_blob* spare = malloc(spareReserved * sizeof(struct measurement_blob));
+    struct blob_spill spilled;
+    pthread_mutex_lock(&logging_mutex);
+    bool highFrequency = (NULL != varSpec->fileSpec && 0 < varSpec->fileSpec->highFrequencyPeriod);
+    if (highFrequency)
+    {
+        pthread_mutex_lock(&high_frequency_mutex);
+    }
+    blobarray_take_spilled(varSpec->logger, &spilled);
+    if (NULL != spare)
+    {
+        saved_nr_results =
+            blobarray_swap_TimeValuePairs(varSpec->logger, spare, spareReserved, time_value_list);
+    }
+    else
+    {
+        /* fall back to copying the logged data points */
+        saved_nr_results = blobarray_get_TimeValuePairs(varSpec->logger, time_value_list);
+        if (0 <= saved_nr_results)
+        {
+            blobarray_reset(varSpec->logger);
+        }
+    }
+    if (highFrequency)
+    {
+        pthread_mutex_unlock(&high_frequency_mutex);
+    }
+    pthread_mutex_unlock(&logging_mutex);
+    if (0 > saved_nr_results)
+    {
+        log_error("Could not allocate memory for passing logging data to Score-P.\n");
+        time_value_list[0] = NULL;
+        saved_nr_results = 0;
+    }
+    /* the values spilled to the scratch file never were in the array, so they do not size it */
+    varSpec->pulledCount = saved_nr_results;
+    /* the values spilled to the scratch file precede the ones in memory */
+    saved_nr_results = blobarray_prepend_spilled(&spilled, time_value_list, saved_nr_results);
+    if (0 > saved_nr_results)
+    {
+        log_error("Could not read back the logged values spilled to the scratch file.\n");
+        return 0;
+    }
+
+    ++calls_to_get_all_values;
+
+    return saved_nr_results;
+}
+
+/**
+ * Looks up the varParams registered with an id
+ */
+static struct varParams* getVarParamsForId(int32_t desiredId)
+{
+    if (0 > desiredId || varParamsById->length <= desiredId)
+    {
+        return NULL;
+    }
+    return varParamsById->data[desiredId];
+}
+/**
+ * Parses a single variable argument returning a pointer to a nice struct
+ *
+ * Can parse strings like these:
+ * netstat:int@/proc/net/netstat+c=7;r=3s=
+ * dev    :int@/proc/net/dev+c=1;r=2;d
+ *
+ * Format:
+ * name:datatype@/path/to/file+parameters
+ * where datatype can be
+ *  int:    int64_t
+ *  uint:   uint64_t
+ *  float:  double
+ *  double: double
+ * where parameters are
+ *  c: column (number of char in the line)
+ *  r: row (number of the line)
+ *  s: separator (character in between data field)
+ *  d: diff (only shows a diff from a starting value)
+ *  p: point (show logged data as point values)
+ */
+static struct fileParams* parseVariableSpecification(char* specStr, int idToBeAssigned)
+{
+    if (NULL == specStr)
+    {
+        return NULL;
+    }
+    struct fileParams* parsedData;
+    parsedData = arena_calloc(1, sizeof(struct fileParams));
+    if (NULL == parsedData)
+    {
+        log_error("Ran out of memory when trying to allocate a few bytes for a fileParams struct.");
+        return NULL;
+    }
+    parsedData->dataDefinitions = vec_create(1);
+    parsedData->binaryDefinitions = vec_create(1);
+
+    if (NULL == parsedData->dataDefinitions || NULL == parsedData->binaryDefinitions)
+    {
+        log_error_string(
+            "Could not allocate memory for vectors in struct fileParams. Input specStr was \"%s\".",
+            specStr);
+        vec_destroy(parsedData->dataDefinitions);
+        vec_destroy(parsedData->binaryDefinitions);
+        arena_free(parsedData);
+        return NULL;
+    }
+
+    char* curStrOffset = NULL;
+    char* posOfCurDelim = NULL;
+
+    /* Parse variable name */
+    curStrOffset = specStr;
+    posOfCurDelim = strchr(specStr, ':');
+    char* curVarName = allocSubstring(specStr, posOfCurDelim);
+    if (NULL != posOfCurDelim)
+    {
+        curStrOffset = posOfCurDelim + 1;
+    }
+
+    /* Parse Datatype argument */
+    posOfCurDelim = strchr(curStrOffset, '@');
+    char* curDatatypeName = allocSubstring(curStrOffset, posOfCurDelim);
+    if (NULL != posOfCurDelim)
+    {
+        curStrOffset = posOfCurDelim + 1;
+    }
+    int inputHex = 0;
+    int inputBinaryWidth = 0;
+    Fileparser_Binary_Datatype binaryDatatype = FILEPARSER_BINARY_DATATYPE_UNDEFINED;
+    SCOREP_MetricValueType curDatatype =
+        parseDatatype(curDatatypeName, &inputHex, &inputBinaryWidth, &binaryDatatype);
+
+    /* Parse Filename */
+    posOfCurDelim = strchr(curStrOffset, '+');
+    char* curFilename = allocSubstring(curStrOffset, posOfCurDelim);
+
+    /* variables required for parsing the position argument */
+    char* nextPosToken = NULL;
+    char* curPosToken = NULL;
+    char* posOfEqualsInPos = NULL;
+    int posRow = 0, posCol = 0, logDif = 0, logPoint = 0;
+    /* a range of columns captured as a whole, lastCol -1 for all numeric columns of the row */
+    bool captureRow = false;
+    int lastCol = 0;
+    uint64_t binaryOffset = 0;
+    char posSep = ' ';
+    struct keywordOptions keywords;
+    memset(&keywords, 0, sizeof(keywords));
+    keywords.threshold = -1;
+    keywords.seqlockOffset = -1;
+
+    /* Parse Position parameters */
+    if (NULL != posOfCurDelim)
+    {
+        /* Tokenize position parameters using delimiter semi-colon */
+        curPosToken = strtok_r(posOfCurDelim + 1, ";", &nextPosToken);
+        while (NULL != curPosToken)
+        {
+            /* options given as keywords take precedence over the single character options */
+            if (parseKeywordOption(curPosToken, &keywords))
+            {
+                curPosToken = strtok_r(NULL, ";", &nextPosToken);
+                continue;
+            }
+
+            /* parse individual positional tokens */
+            posOfEqualsInPos = strchr(curPosToken, '=');
+            switch (curPosToken[0])
+            {
+            case 'C': /* fall-through */
+            case 'c':
+                if (NULL != posOfEqualsInPos && '*' == posOfEqualsInPos[1])
+                {
+                    captureRow = true;
+                    posCol = 0;
+                    lastCol = -1;
+                }
+                else if (NULL != posOfEqualsInPos)
+                {
+                    char* endPtr;
+                    posCol = strtol(posOfEqualsInPos + 1, &endPtr, 10);
+                    if ('-' == endPtr[0])
+                    {
+                        captureRow = true;
+                        lastCol = atoi(endPtr + 1);
+                        if (lastCol < posCol)
+                        {
+                            log_error("The last column of option C precedes its first column.");
+                            lastCol = posCol;
+                        }
+                    }
+                }
+                else
+                {
+                    log_error("Can't parse option C, no parameter provided.");
+                }
+                break;
+            case 'L': /* fall-through */
+            case 'l': /* fall-through */
+            case 'R': /* fall-through */
+            case 'r':
+                if (NULL != posOfEqualsInPos)
+                {
+                    posRow = atoi(posOfEqualsInPos + 1);
+                }
+                else
+                {
+                    log_error("Can't parse option R, no parameter provided.");
+                }
+                break;
+            case 'S': /* fall-through */
+            case 's':
+                if (NULL != posOfEqualsInPos)
+                {
+                    posSep = (posOfEqualsInPos + 1)[0];
+                }
+                else
+                {
+                    log_error("Can't parse option S, no parameter provided.");
+                }
+                break;
+            case 'D': /* fall-through*/
+            case 'd':
+                logDif = 1;
+                break;
+            case 'P': /* fall-through*/
+            case 'p':
+                logPoint = 1;
+                break;
+            case 'A': /* fall-through */
+            case 'a':
+                logPoint = 0;
+                break;
+            case 'B': /* fall-through */
+            case 'b':
                 if (NULL != posOfEqualsInPos)
                 {
-                    posSep = (posOfEqualsInPos + 1)[0];
+                    char* endPtr;
+                    binaryOffset = strtoull(posOfEqualsInPos + 1, &endPtr, 0);
+                }
+                else
+                {
+                    log_error("Can't parse option B, no parameter provided.");
+                }
+                break;
+            }
+            curPosToken = strtok_r(NULL, ";", &nextPosToken);
+        }
+
+        /* try setting up new varSpec */
+        struct varParams* varSpec = arena_calloc(1, sizeof(struct varParams));
+        if (NULL == varSpec)
+        {
+            log_error(
+                "Ran out of memory when trying to allocate a few bytes for a varParams struct.");
+            vec_destroy(parsedData->dataDefinitions);
+            vec_destroy(parsedData->binaryDefinitions);
+            arena_free(parsedData);
+            free(curVarName);
+            free(curDatatypeName);
+            free(curFilename);
+            return NULL;
+        }
+
+        /* assign the actual values */
+        varSpec->id = idToBeAssigned;
+        varSpec->name = curVarName;
+        varSpec->doLog = false;
+        varSpec->datatype = curDatatype;
+        parsedData->filename = curFilename;
+        parsedData->fileDescriptor = NULL;
+        parsedData->prefetchLength = -1;
+        parsedData->notifyMode =
+            keywords.notify ? FILEPARSER_NOTIFY_REQUESTED : FILEPARSER_NOTIFY_NONE;
+        parsedData->inotifyWatch = -1;
+        /* the period adapts between minPeriod and maxPeriod, which default to the fixed period */
+        parsedData->minPeriod = (0 < keywords.minPeriod) ? keywords.minPeriod : sleep_duration;
+        parsedData->maxPeriod = (0 < keywords.maxPeriod) ? keywords.maxPeriod : sleep_duration;
+        parsedData->isAdaptive = (parsedData->minPeriod < parsedData->maxPeriod);
+        parsedData->curPeriod = parsedData->minPeriod;
+        parsedData->adaptThreshold = (0 <= keywords.threshold) ? keywords.threshold : 0;
+        parsedData->useMmap = keywords.useMmap;
+        parsedData->checkStat = keywords.checkStat;
+        parsedData->deadline = (0 < keywords.deadline) ? keywords.deadline : 0;
+        parsedData->defer = keywords.defer;
+        parsedData->highFrequencyPeriod =
+            (0 < keywords.highFrequencyPeriod) ? llround(keywords.highFrequencyPeriod * 1000) : 0;
+        parsedData->lastContentLength = -1;
+        parsedData->seqlockOffset = keywords.seqlockOffset;
+        varSpec->posCol = posCol;
+        varSpec->posRow = posRow;
+        varSpec->posSep = posSep;
+        varSpec->logDif = logDif;
+        varSpec->logPoint = logPoint;
+        varSpec->inputHex = inputHex;
+        varSpec->inputBinaryWidth = inputBinaryWidth;
+        varSpec->binaryOffset = binaryOffset;
+        varSpec->binaryDatatype = binaryDatatype;
+
+        /* oh no, we could not append this definition, return NULL */
+        if (vec_append(parsedData->dataDefinitions, varSpec))
+        {
+            log_error("Ran out of memory when trying to insert a varParams struct into a vector of "
+                      "a fileParams struct.");
+            vec_destroy(parsedData->dataDefinitions);
+            vec_destroy(parsedData->binaryDefinitions);
+            arena_free(parsedData);
+            free(curVarName);
+            free(curDatatypeName);
+            free(curFilename);
+            return NULL;
+        }
+
+        /* a binary array defines one varParams per element */
+        if (0 < inputBinaryWidth && (1 < keywords.count || 0 != keywords.byteOrder))
+        {
+            if (expandBinaryArray(parsedData, varSpec, &keywords))
+            {
+                log_error("Ran out of memory when trying to allocate the elements of an array.");
+                for (int i = 0; i < parsedData->dataDefinitions->length; ++i)
+                {
+                    freeVarParams(parsedData->dataDefinitions->data[i]);
+                }
+                vec_destroy(parsedData->dataDefinitions);
+                vec_destroy(parsedData->binaryDefinitions);
+                arena_free(parsedData);
+                free(curDatatypeName);
+                free(curFilename);
+                return NULL;
+            }
+        }
+        else if (1 < keywords.count)
+        {
+            log_error("Option n is only supported for binary datatypes, reading a single value.");
+        }
+        /* a row captured as a whole defines one varParams per column */
+        else if (captureRow && 0 == inputBinaryWidth)
+        {
+            if (expandTextRow(parsedData, varSpec, posCol, lastCol))
+            {
+                for (int i = 0; i < parsedData->dataDefinitions->length; ++i)
+                {
+                    freeVarParams(parsedData->dataDefinitions->data[i]);
+                }
+                vec_destroy(parsedData->dataDefinitions);
+                vec_destroy(parsedData->binaryDefinitions);
+                free(parsedData->filename);
+                arena_free(parsedData);
+                free(curDatatypeName);
+                return NULL;
+            }
+        }
+        else if (captureRow)
+        {
+            log_error("Ranges of columns are not supported for binary datatypes, ignoring them.");
+        }
+    }
+    else
+    {
+        /* invalid variable given
+         * discard data (i.e. do a free on all the allocated strings) */
+        vec_destroy(parsedData->dataDefinitions);
+        vec_destroy(parsedData->binaryDefinitions);
+        arena_free(parsedData);
+        free(curVarName);
+        free(curDatatypeName);
+        free(curFilename);
+        return NULL;
+    }
+    free(curDatatypeName);
+
+    return parsedData;
+}
+
+/**
+ * Turns a freshly parsed binary varParams into the head of an array: appends one varParams for
+ * each further element to the dataDefinitions of fileSpec, named "<name>[<index>]"
+ *
+ * @return Returns 0 on success, a value greater than that on error
+ */
+static int expandBinaryArray(struct fileParams* fileSpec, struct varParams* head,
+                             struct keywordOptions* keywords)
+{
+    int count = (1 < keywords->count) ? keywords->count : 1;
+    uint64_t stride = (0 < keywords->stride) ? keywords->stride : (uint64_t)head->inputBinaryWidth;
+    if (stride < (uint64_t)head->inputBinaryWidth)
+    {
+        log_error("Option stride is smaller than the datatype, using the width of the datatype.");
+        stride = head->inputBinaryWidth;
+    }
+    head->arrayHead = head;
+    head->arrayIndex = 0;
+    head->arrayCount = count;
+    head->arrayStride = stride;
+    head->swapBytes = (0 != keywords->byteOrder && __BYTE_ORDER__ != keywords->byteOrder);
+    head->arrayValues = arena_calloc(count, sizeof(uint64_t));
+    if (NULL == head->arrayValues)
+    {
+        return 1;
+    }
+    if (1 == count)
+    {
+        return 0;
+    }
+
+    char* baseName = head->name;
+    head->name = allocIndexedName(baseName, 0);
+    if (NULL == head->name)
+    {
+        head->name = baseName;
+        return 2;
+    }
+    for (int i = 1; i < count; ++i)
+    {
+        struct varParams* element = arena_calloc(1, sizeof(struct varParams));
+        if (NULL == element)
+        {
+            free(baseName);
+            return 3;
+        }
+        memcpy(element, head, sizeof(struct varParams));
+        element->id = head->id + i;
+        element->name = allocIndexedName(baseName, i);
+        element->arrayIndex = i;
+        element->binaryOffset = head->binaryOffset + i * stride;
+        element->arrayValues = NULL;
+        if (NULL == element->name || vec_append(fileSpec->dataDefinitions, element))
+        {
+            arena_free(element->name);
+            arena_free(element);
+            free(baseName);
+            return 4;
+        }
+    }
+    free(baseName);
+    return 0;
+}
+
+/**
+ * Turns a freshly parsed text varParams into the first column of a row captured as a whole:
+ * appends one varParams for each further column to the dataDefinitions of fileSpec, named
+ * "<name>[<column>]". With lastCol -1, the columns holding a number at registration are captured.
+ *
+ * @return Returns 0 on success, a value greater than that on error
+ */
+static int expandTextRow(struct fileParams* fileSpec, struct varParams* head, int firstCol,
+                         int lastCol)
+{
+    bool* isNumeric = NULL;
+    if (-1 == lastCol && findNumericColumns(head, fileSpec->filename, &firstCol, &lastCol,
+                                            &isNumeric))
+    {
+        return 1;
+    }
+
+    char* baseName = head->name;
+    head->name = allocIndexedName(baseName, firstCol);
+    if (NULL == head->name)
+    {
+        head->name = baseName;
+        free(isNumeric);
+        return 2;
+    }
+    head->posCol = firstCol;
+    int nextId = head->id + 1;
+    for (int col = firstCol + 1; col <= lastCol; ++col)
+    {
+        if (NULL != isNumeric && !isNumeric[col])
+        {
+            continue;
+        }
+        struct varParams* element = arena_calloc(1, sizeof(struct varParams));
+        if (NULL == element)
+        {
+            free(baseName);
+            free(isNumeric);
+            return 3;
+        }
+        memcpy(element, head, sizeof(struct varParams));
+        element->id = nextId++;
+        element->name = allocIndexedName(baseName, col);
+        element->posCol = col;
+        if (NULL == element->name || vec_append(fileSpec->dataDefinitions, element))
+        {
+            arena_free(element->name);
+            arena_free(element);
+            free(baseName);
+            free(isNumeric);
+            return 4;
+        }
+    }
+    free(baseName);
+    free(isNumeric);
+    return 0;
+}
+
+/**
+ * Reads the row of varSpec once to find out which of its columns hold a number, which can then be
+ * captured as a whole. Columns like the name of a device or a cpu are left out.
+ *
+ * @return Returns 0 on success with the first and the last numeric column and isNumeric (to be
+ * freed by the caller) marking all of them, a value greater than that if the row can not be read
+ * or holds no number
+ */
+static int findNumericColumns(struct varParams* varSpec, const char* filename, int* firstCol,
+                              int* lastCol, bool** isNumeric)
+{
+    FILE* file = fopen(filename, "r");
+    if (NULL == file)
+    {
+        log_error_string("Could not read the row to be captured from \"%s\".", (char*)filename);
+        return 1;
+    }
+    char* line = NULL;
+    size_t lineReserve = 0;
+    ssize_t lineLength = -1;
+    for (int row = 0; row <= varSpec->posRow; ++row)
+    {
+        lineLength = getline(&line, &lineReserve, file);
+        if (0 > lineLength)
+        {
+            break;
+        }
+    }
+    fclose(file);
+    if (0 > lineLength)
+    {
+        log_error_string("The row to be captured does not exist in \"%s\".", (char*)filename);
+        free(line);
+        return 2;
+    }
+
+    char separator[] = { varSpec->posSep, '\n', 0 };
+    int columnCount = 0;
+    int reserve = 16;
+    *isNumeric = malloc(reserve * sizeof(bool));
+    *firstCol = -1;
+    char* nextToken = NULL;
+    for (char* curToken = strtok_r(line, separator, &nextToken);
+         NULL != curToken && NULL != *isNumeric;
+         curToken = strtok_r(NULL, separator, &nextToken), ++columnCount)
+    {
+        if (columnCount == reserve)
+        {
+            reserve *= 2;
+            bool* grown = realloc(*isNumeric, reserve * sizeof(bool));
+            if (NULL == grown)
+            {
+                free(*isNumeric);
+                *isNumeric = NULL;
+                break;
+            }
+            *isNumeric = grown;
+        }
+        char* endPtr = curToken;
+        if (varSpec->inputHex)
+        {
+            /* labels like "cpu0" or "dead" would pass for hex numbers, thus a hex column must
+             * consist of a single number which begins with a digit */
+            const char* digits = curToken + strspn(curToken, " \t");
+            strtoull(digits, &endPtr, 16);
+            endPtr += strspn(endPtr, " \t\r");
+            if ('0' > digits[0] || '9' < digits[0] || '\0' != *endPtr)
+            {
+                endPtr = curToken;
+            }
+        }
+        else
+        {
+            strtod(curToken, &endPtr);
+        }
+        (*isNumeric)[columnCount] = (endPtr != curToken);
+        if ((*isNumeric)[columnCount])
+        {
+            *firstCol = (-1 == *firstCol) ? columnCount : *firstCol;
+            *lastCol = columnCount;
+        }
+    }
+    free(line);
+    if (NULL == *isNumeric)
+    {
+        log_error("Could not allocate memory for the columns of a row.");
+        return 3;
+    }
+    if (-1 == *firstCol)
+    {
+        log_error_string("The row to be captured in \"%s\" holds no number.", (char*)filename);
+        free(*isNumeric);
+        *isNumeric = NULL;
+        return 4;
+    }
+    return 0;
+}
+
+/**
+ * Allocates the name of an element of a metric that is defined as a whole, i.e. "<name>[<index>]"
+ */
+static char* allocIndexedName(const char* name, int index)
+{
+    if (NULL == name)
+    {
+        name = "";
+    }
+    size_t length = strlen(name) + 16;
+    char* indexedName = arena_calloc(length, sizeof(char));
+    if (NULL == indexedName)
+    {
+        log_error("Could not allocate memory for the name of an element.");
+        return NULL;
+    }
+    snprintf(indexedName, length, "%s[%d]", name, index);
+    return indexedName;
+}
+
+/**
+ * Parses an option given as keyword into options
+ *
+ * @return Returns true if token is a known keyword, false if it is to be parsed as single character
+ * option
+ */
+static bool parseKeywordOption(char* token, struct keywordOptions* options)
+{
+    if (0 == strcasecmp(token, "notify"))
+    {
+        options->notify = true;
+        return true;
+    }
+    if (0 == strncasecmp(token, "min=", 4))
+    {
+        options->minPeriod = atoi(token + 4);
+        return true;
+    }
+    if (0 == strncasecmp(token, "max=", 4))
+    {
+        options->maxPeriod = atoi(token + 4);
+        return true;
+    }
+    if (0 == strncasecmp(token, "threshold=", 10))
+    {
+        options->threshold = strtod(token + 10, NULL);
+        return true;
+    }
+    if (0 == strncasecmp(token, "n=", 2))
+    {
+        options->count = atoi(token + 2);
+        return true;
+    }
+    if (0 == strncasecmp(token, "stride=", 7))
+    {
+        options->stride = strtoull(token + 7, NULL, 0);
+        return true;
+    }
+    if (0 == strcasecmp(token, "stat"))
+    {
+        options->checkStat = true;
+        return true;
+    }
+    if (0 == strcasecmp(token, "defer"))
+    {
+        options->defer = true;
+        return true;
+    }
+    if (0 == strncasecmp(token, "hf=", 3))
+    {
+        options->highFrequencyPeriod = strtod(token + 3, NULL);
+        return true;
+    }
+    if (0 == strncasecmp(token, "deadline=", 9))
+    {
+        options->deadline = atoi(token + 9);
+        return true;
+    }
+    if (0 == strcasecmp(token, "mmap"))
+    {
+        options->useMmap = true;
+        return true;
+    }
+    if (0 == strncasecmp(token, "seq=", 4))
+    {
+        options->useMmap = true;
+        options->seqlockOffset = strtoll(token + 4, NULL, 0);
+        return true;
+    }
+    if (0 == strcasecmp(token, "be"))
+    {
+        options->byteOrder = __ORDER_BIG_ENDIAN__;
+        return true;
+    }
+    if (0 == strcasecmp(token, "le"))
+    {
+        options->byteOrder = __ORDER_LITTLE_ENDIAN__;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * Parses a given curDatatypeName returning the read datatype and setting the arguments accordingly
+ */
+static SCOREP_MetricValueType parseDatatype(char* curDatatypeName, int* inputHex,
+                                            int* inputBinaryWidth,
+                                            Fileparser_Binary_Datatype* binaryDatatype)
+{
+    SCOREP_MetricValueType curDatatype = SCOREP_METRIC_VALUE_INT64;
+
+    if (NULL == curDatatypeName || 0 == strcasecmp(curDatatypeName, "int"))
+    {
+        curDatatype = SCOREP_METRIC_VALUE_INT64;
+    }
+    else if (0 == strcasecmp(curDatatypeName, "int_hex"))
+    {
+        curDatatype = SCOREP_METRIC_VALUE_INT64;
+        *inputHex = 1;
+    }
+    else if (0 == strcasecmp(curDatatypeName, "uint"))
+    {
+        curDatatype = SCOREP_METRIC_VALUE_UINT64;
+    }
+    else if (0 == strcasecmp(curDatatypeName, "uint_hex"))
+    {
+        curDatatype = SCOREP_METRIC_VALUE_UINT64;
+        *inputHex = 1;
+    }
+    else if (0 == strcasecmp(curDatatypeName, "float") ||
+             0 == strcasecmp(curDatatypeName, "double"))
+    {
+        curDatatype = SCOREP_METRIC_VALUE_DOUBLE;
+    }
+    else if (0 == strcasecmp(curDatatypeName, "int8_bin"))
+    {
+        *binaryDatatype = FILEPARSER_BINARY_DATATYPE_INT8;
+        *inputBinaryWidth = 1;
+        curDatatype = SCOREP_METRIC_VALUE_INT64;
+    }
+    else if (0 == strcasecmp(curDatatypeName, "int16_bin"))
+    {
+        *binaryDatatype = FILEPARSER_BINARY_DATATYPE_INT16;
+        *inputBinaryWidth = 2;
+        curDatatype = SCOREP_METRIC_VALUE_INT64;
+    }
+    else if (0 == strcasecmp(curDatatypeName, "int32_bin"))
+    {
+        *binaryDatatype = FILEPARSER_BINARY_DATATYPE_INT32;
+        *inputBinaryWidth = 4;
+        curDatatype = SCOREP_METRIC_VALUE_INT64;
+    }
+    else if (0 == strcasecmp(curDatatypeName, "int64_bin"))
+    {
+        *binaryDatatype = FILEPARSER_BINARY_DATATYPE_INT64;
+        *inputBinaryWidth = 8;
+        curDatatype = SCOREP_METRIC_VALUE_INT64;
+    }
+    else if (0 == strcasecmp(curDatatypeName, "uint8_bin"))
+    {
+        *binaryDatatype = FILEPARSER_BINARY_DATATYPE_UINT8;
+        *inputBinaryWidth = 1;
+        curDatatype = SCOREP_METRIC_VALUE_UINT64;
+    }
+    else if (0 == strcasecmp(curDatatypeName, "uint16_bin"))
+    {
+        *binaryDatatype = FILEPARSER_BINARY_DATATYPE_UINT16;
+        *inputBinaryWidth = 2;
+        curDatatype = SCOREP_METRIC_VALUE_UINT64;
+    }
+    else if (0 == strcasecmp(curDatatypeName, "uint32_bin"))
+    {
+        *binaryDatatype = FILEPARSER_BINARY_DATATYPE_UINT32;
+        *inputBinaryWidth = 4;
+        curDatatype = SCOREP_METRIC_VALUE_UINT64;
+    }
+    else if (0 == strcasecmp(curDatatypeName, "uint64_bin"))
+    {
+        *binaryDatatype = FILEPARSER_BINARY_DATATYPE_UINT64;
+        *inputBinaryWidth = 8;
+        curDatatype = SCOREP_METRIC_VALUE_UINT64;
+    }
+    else if (0 == strcasecmp(curDatatypeName, "float_bin"))
+    {
+        *binaryDatatype = FILEPARSER_BINARY_DATATYPE_FLOAT;
+        *inputBinaryWidth = 4;
+        curDatatype = SCOREP_METRIC_VALUE_DOUBLE;
+    }
+    else if (0 == strcasecmp(curDatatypeName, "double_bin"))
+    {
+        *binaryDatatype = FILEPARSER_BINARY_DATATYPE_DOUBLE;
+        *inputBinaryWidth = 8;
+        curDatatype = SCOREP_METRIC_VALUE_DOUBLE;
+    }
+    else
+    {
+        log_error_string("Could not parse datatype \"%s\".", curDatatypeName);
+    }
+
+    return curDatatype;
+}
+
+/**
+ * Parses a whole file according to parameters given with fileSpec and returns an array of found
+ * results "Files öffnen und schliessen ist immer sehr teuer" (Robert Schöne) DONE: declare the used
+ * variables as static, thereby they will be kept as global variables (within the file; even when I
+ * declare them within a method to be static) of course this also means I will have to allocate them
+ * at the beginning and have to free them at the end
+ */
+static struct Vector* parseWholeFile(struct fileParams* fileSpec, bool verbose)
+{
+    /* content prefetched by a batched read is consumed instead of reading the file again */
+    FILE* fileDescriptor = NULL;
+    ssize_t prefetchLength = fileSpec->prefetchLength;
+    size_t prefetchOffset = 0;
+    bool binaryPrefetched = fileSpec->binaryPrefetched;
+    fileSpec->prefetchLength = -1;
+    fileSpec->binaryPrefetched = false;
+    if (0 == fileSpec->isAccessible)
+    {
+        return NULL;
+    }
+
+    struct Vector* foundValuesVec = vec_create(fileSpec->dataDefinitions->length +
+                                               fileSpec->binaryDefinitions->length);
+    if (NULL == foundValuesVec)
+    {
+        log_error("Could not allocate vector to store the values found in a file.");
+        return NULL;
+    }
+
+    /* mapped files are parsed directly from their mapping */
+    const char* prefetchSource = fileSpec->prefetchBuf;
+    if (fileSpec->useMmap && 0 == mapFile(fileSpec))
+    {
+        if (0 < fileSpec->binaryDefinitions->length)
+        {
+            uint64_t readStart = monotonicNanoseconds();
+            copyBinaryRangesFromMapping(fileSpec);
+            noteRead(fileSpec, readStart, monotonicNanoseconds());
+            extractBinaryValues(fileSpec, foundValuesVec);
+        }
+        prefetchSource = fileSpec->mapping;
+        prefetchLength = fileSpec->mappingLength;
+    }
+    /* the reader of a file with a deadline read the binary values already */
+    else if (binaryPrefetched)
+    {
+        extractBinaryValues(fileSpec, foundValuesVec);
+    }
+    /* binary values are read from their offsets directly, without reading the whole file */
+    else if (0 < fileSpec->binaryDefinitions->length && NULL != openFileDescriptor(fileSpec))
+    {
+        uint64_t readStart = monotonicNanoseconds();
+        readBinaryRanges(fileSpec);
+        noteRead(fileSpec, readStart, monotonicNanoseconds());
+        extractBinaryValues(fileSpec, foundValuesVec);
+    }
+    if (0 == fileSpec->dataDefinitions->length)
+    {
+        return foundValuesVec;
+    }
+    if (0 > prefetchLength)
+    {
+        /* Try to get a file descriptor pointing to the beginning of the file */
+        fileDescriptor = prepareFileDescriptorForParsing(fileSpec);
+        if (NULL == fileDescriptor)
+        {
+            return foundValuesVec;
+        }
+    }
+
+    size_t readReturn = -1;
+    char* overlapBuf = NULL;
+    char* overlapSwapBuf = NULL;
+    char* curNewlineIndex = NULL;
+    char* prevIndex = NULL;
+    int curLineNumber = 0;
+    int varParamsIndex = 0;
+    const struct textColumns* columns = fileSpec->textColumns;
+    /* content prefetched by the sampler was bracketed by the prefetch already */
+    bool bracketsRead = (NULL != fileDescriptor || prefetchSource == fileSpec->mapping);
+
+    do
+    {
+        uint64_t readStart = bracketsRead ? monotonicNanoseconds() : 0;
+        /* do read from file, or take the next chunk of the prefetched content */
+        if (NULL == fileDescriptor)
+        {
+            readReturn = prefetchLength - prefetchOffset;
+            if (DEFAULT_BUFSIZE - 1 < readReturn)
+            {
+                readReturn = DEFAULT_BUFSIZE - 1;
+            }
+            memcpy(readBuf, prefetchSource + prefetchOffset, readReturn);
+            prefetchOffset += readReturn;
+        }
+        else
+        {
+            readReturn = fread(readBuf, 1, DEFAULT_BUFSIZE - 1, fileDescriptor);
+            __atomic_fetch_add(&cycleBytesRead, readReturn, __ATOMIC_RELAXED);
+        }
+        if (bracketsRead)
+        {
+            /* only the reads count towards the latency, not the parsing in between */
+            noteRead(fileSpec, readStart, monotonicNanoseconds());
+        }
+        if (0 < readReturn)
+        {
+            readBuf[readReturn] = '\0';
+
+            curNewlineIndex = strchr(readBuf, '\n');
+            /* if no newline was found in the current read out, then append it all to overlapBuf */
+            if (NULL == curNewlineIndex)
+            {
+                if (NULL == overlapBuf)
+                {
+                    overlapBuf = "";
                 }
-                else
+                overlapSwapBuf = malloc(strlen(overlapBuf) + readReturn + 1);
+                if (NULL == overlapSwapBuf)
                 {
-                    log_error("Can't parse option S, no parameter provided.");
+                    log_error("Could not allocate memory for storing the read from readBuf.");
+                    free(overlapBuf);
+                    vec_destroy(foundValuesVec);
+                    return NULL;
+                }
+                sprintf(overlapSwapBuf, "%s%s", overlapBuf, readBuf);
+                overlapBuf = overlapSwapBuf;
+            }
+            else
+            {
+                /* we found a newline in the current read out, thus we can process it */
+                prevIndex = readBuf;
+
+                /* overlapBuf is not empty, i.e. last call to read did not end with a newline */
+                if (NULL != overlapBuf)
+                {
+                    curNewlineIndex[0] = '\0';
+
+                    /* try allocating some memory for the current line */
+                    int tempLen = strlen(overlapBuf) + strlen(readBuf) + 1;
+                    overlapSwapBuf = malloc(tempLen);
+                    if (NULL == overlapSwapBuf)
+                    {
+                        log_error(
+                            "Could not allocate memory for parsing the current line in a file.");
+                        free(overlapBuf);
+                        vec_destroy(foundValuesVec);
+                        return NULL;
+                    }
+                    sprintf(overlapSwapBuf, "%s%s", overlapBuf, readBuf);
+                    free(overlapBuf);
+                    overlapBuf = overlapSwapBuf;
+
+                    processLine(fileSpec, columns, &varParamsIndex, curLineNumber,
+                                foundValuesVec, overlapBuf, verbose);
+                    ++curLineNumber;
+
+                    /* a bit of cleanup */
+                    free(overlapBuf);
+                    overlapBuf = NULL;
+                    prevIndex = curNewlineIndex + 1;
+                    curNewlineIndex = strchr(curNewlineIndex + 1, '\n');
                 }
-                break;
-            case 'D': /* fall-through*/
-            case 'd':
-                logDif = 1;
-                break;
-            case 'P': /* fall-through*/
-            case 'p':
-                logPoint = 1;
-                break;
-            case 'A': /* fall-through */
-            case 'a':
-                logPoint = 0;
-                break;
-            case 'B': /* fall-through */
-            case 'b':
-                if (NULL != posOfEqualsInPos)
+                /* go through readBuf processing each line */
+                for (; NULL != curNewlineIndex; curNewlineIndex = strchr(curNewlineIndex + 1, '\n'))
                 {
-                    char* endPtr;
-                    binaryOffset = strtoull(posOfEqualsInPos + 1, &endPtr, 0);
+                    curNewlineIndex[0] = '\0';
+                    processLine(fileSpec, columns, &varParamsIndex, curLineNumber,
+                                foundValuesVec, prevIndex, verbose);
+                    ++curLineNumber;
+
+                    prevIndex = curNewlineIndex + 1;
                 }
-                else
+                /* process remainder/trailing line, put it in overlapBuf */
+                if ((readBuf + readReturn) > prevIndex)
                 {
-                    log_error("Can't parse option B, no parameter provided.");
+                    overlapBuf = strdup(prevIndex);
                 }
-                break;
             }
-            curPosToken = strtok_r(NULL, ";", &nextPosToken);
         }
 
-        /* try setting up new varSpec */
-        struct varParams* varSpec = calloc(1, sizeof(struct varParams));
-        if (NULL == varSpec)
+    } while (0 < readReturn);
+
+    /* process last line */
+    if (NULL != overlapBuf)
+    {
+        processLine(fileSpec, columns, &varParamsIndex, curLineNumber, foundValuesVec, overlapBuf,
+                    verbose);
+        ++curLineNumber;
+        free(overlapBuf);
+    }
+
+    return foundValuesVec;
+}
+/**
+ * Tries to get a file Descriptor for the file denoted in varParams, if a fileDescriptor is already
+ * there, seek to beginning of file
+ */
+static FILE* prepareFileDescriptorForParsing(struct fileParams* fileSpec)
+{
+    /* try getting a valid file descriptor */
+    FILE* fileDescriptor = fileSpec->fileDescriptor;
+    if (NULL == fileDescriptor)
+    {
+        return openFileDescriptor(fileSpec);
+    }
+    else
+    {
+        /* try to seek to the beginning of the file */
+        int newOffset = fseek(fileDescriptor, 0, SEEK_SET);
+        if (-1 == newOffset)
         {
-            log_error(
-                "Ran out of memory when trying to allocate a few bytes for a varParams struct.");
-            vec_destroy(parsedData->dataDefinitions);
-            vec_destroy(parsedData->binaryDefinitions);
-            free(parsedData);
-            free(curVarName);
-            free(curDatatypeName);
-            free(curFilename);
-            return NULL;
+            /* if seeking fails, do close and open the file again */
+            log_error("Failed to reset the read offset using fseek.");
+            fprintf(stderr, "File \"%s\" is affected. errno = %d\n", fileSpec->filename, errno);
+            fclose(fileDescriptor);
+            fileSpec->fileDescriptor = NULL;
+            return openFileDescriptor(fileSpec);
         }
+    }
 
-        /* assign the actual values */
-        varSpec->id = idToBeAssigned;
-        varSpec->name = curVarName;
-        varSpec->doLog = false;
-        varSpec->datatype = curDatatype;
-        parsedData->filename = curFilename;
-        parsedData->fileDescriptor = NULL;
-        varSpec->posCol = posCol;
-        varSpec->posRow = posRow;
-        varSpec->posSep = posSep;
-        varSpec->logDif = logDif;
-        varSpec->logPoint = logPoint;
-        varSpec->inputHex = inputHex;
-        varSpec->inputBinaryWidth = inputBinaryWidth;
-        varSpec->binaryOffset = binaryOffset;
-        varSpec->binaryDatatype = binaryDatatype;
+    return fileDescriptor;
+}
 
-        /* oh no, we could not append this definition, return NULL */
-        if (vec_append(parsedData->dataDefinitions, varSpec))
+/**
+ * Returns the file descriptor of fileSpec, opening the file if that did not happen yet
+ */
+static FILE* openFileDescriptor(struct fileParams* fileSpec)
+{
+    if (NULL == fileSpec->fileDescriptor && NULL != fileSpec->filename)
+    {
+        fileSpec->fileDescriptor = fopen(fileSpec->filename, "r");
+    }
+    return fileSpec->fileDescriptor;
+}
+
+/**
+ * Reads the content of all files due in this cycle with a single batch of io_uring reads at offset
+ * 0, so parseWholeFile can parse them without issuing any further syscalls. Files which could not
+ * be read that way are left without prefetched content and fall back to fseek and fread.
+ */
+static void prefetchDueFiles(struct Vector* fileSpecVec)
+{
+    if (!useBatchRead || 0 == fileSpecVec->length)
+    {
+        return;
+    }
+    if (batchRequestsReserve < fileSpecVec->length)
+    {
+        struct batch_read_request* reallocRequests =
+            realloc(batchRequests, fileSpecVec->length * sizeof(struct batch_read_request));
+        if (NULL == reallocRequests)
         {
-            log_error("Ran out of memory when trying to insert a varParams struct into a vector of "
-                      "a fileParams struct.");
-            vec_destroy(parsedData->dataDefinitions);
-            vec_destroy(parsedData->binaryDefinitions);
-            free(parsedData);
-            free(curVarName);
-            free(curDatatypeName);
-            free(curFilename);
-            return NULL;
+            return;
+        }
+        batchRequests = reallocRequests;
+        struct fileParams** reallocFiles =
+            realloc(batchRequestFiles, fileSpecVec->length * sizeof(struct fileParams*));
+        if (NULL == reallocFiles)
+        {
+            return;
         }
+        batchRequestFiles = reallocFiles;
+        batchRequestsReserve = fileSpecVec->length;
     }
-    else
+
+    int requestCount = 0;
+    for (int i = 0; i < fileSpecVec->length; ++i)
     {
-        /* invalid variable given
-         * discard data (i.e. do a free on all the allocated strings) */
-        vec_destroy(parsedData->dataDefinitions);
-        vec_destroy(parsedData->binaryDefinitions);
-        free(parsedData);
-        free(curVarName);
-        free(curDatatypeName);
-        free(curFilename);
-        return NULL;
+        struct fileParams* fileSpec = fileSpecVec->data[i];
+        if (0 < fileSpec->highFrequencyPeriod)
+        {
+            /* the buffer of the file belongs to the high-frequency sampling thread */
+            continue;
+        }
+        fileSpec->prefetchLength = -1;
+        /* files only holding binary values are not read as a whole, mapped files not at all */
+        if (!fileSpec->isDue || 0 == fileSpec->isAccessible ||
+            0 == fileSpec->dataDefinitions->length || fileSpec->useMmap ||
+            fileSpec->isUnchanged || fileSpec->readPosted || NULL == openFileDescriptor(fileSpec))
+        {
+            continue;
+        }
+        if (NULL == fileSpec->prefetchBuf)
+        {
+            fileSpec->prefetchBuf = malloc(DEFAULT_BUFSIZE);
+            if (NULL == fileSpec->prefetchBuf)
+            {
+                continue;
+            }
+            fileSpec->prefetchReserve = DEFAULT_BUFSIZE;
+        }
+        batchRequests[requestCount].fd = fileno(fileSpec->fileDescriptor);
+        batchRequests[requestCount].buf = fileSpec->prefetchBuf;
+        batchRequests[requestCount].length = fileSpec->prefetchReserve;
+        batchRequests[requestCount].result = -1;
+        batchRequestFiles[requestCount] = fileSpec;
+        ++requestCount;
+    }
+    if (0 == requestCount)
+    {
+        return;
     }
-    free(curDatatypeName);
 
-    return parsedData;
+    int queueDepth = requestCount;
+    if (BATCHREAD_MAX_QUEUE_DEPTH < queueDepth)
+    {
+        queueDepth = BATCHREAD_MAX_QUEUE_DEPTH;
+    }
+    uint64_t batchStart = monotonicNanoseconds();
+    if (batchread_init(queueDepth) || batchread_submit(batchRequests, requestCount))
+    {
+        /* io_uring is not available, stick to the regular reads from now on */
+        useBatchRead = false;
+        return;
+    }
+    /* the reads of a batch run in parallel, so all of them are bracketed by the whole batch */
+    uint64_t batchEnd = monotonicNanoseconds();
+
+    for (int i = 0; i < requestCount; ++i)
+    {
+        struct fileParams* fileSpec = batchRequestFiles[i];
+        ssize_t result = batchRequests[i].result;
+        if (0 > result)
+        {
+            continue;
+        }
+        __atomic_fetch_add(&cycleBytesRead, result, __ATOMIC_RELAXED);
+        if ((size_t)result == fileSpec->prefetchReserve)
+        {
+            /* the file may be larger than the buffer, read it the regular way this time and have a
+             * larger buffer ready for the next cycle */
+            char* reallocBuf = realloc(fileSpec->prefetchBuf, fileSpec->prefetchReserve * 2);
+            if (NULL != reallocBuf)
+            {
+                fileSpec->prefetchBuf = reallocBuf;
+                fileSpec->prefetchReserve *= 2;
+            }
+            continue;
+        }
+        fileSpec->prefetchLength = result;
+        noteRead(fileSpec, batchStart, batchEnd);
+    }
 }
 
 /**
- * Parses a given curDatatypeName returning the read datatype and setting the arguments accordingly
+ * Posts the reads of all files with a deadline which are due in this cycle to their readers, which
+ * are started on first use. A reader still stuck in the read of a previous cycle gets no new read.
  */
-static SCOREP_MetricValueType parseDatatype(char* curDatatypeName, int* inputHex,
-                                            int* inputBinaryWidth,
-                                            Fileparser_Binary_Datatype* binaryDatatype)
+static void postDeadlineReads(struct Vector* fileSpecVec)
 {
-    SCOREP_MetricValueType curDatatype = SCOREP_METRIC_VALUE_INT64;
+    for (int i = 0; i < fileSpecVec->length; ++i)
+    {
+        struct fileParams* fileSpec = fileSpecVec->data[i];
+        fileSpec->readPosted = false;
+        /* mapped files are read with memory loads, which do not stall */
+        if (0 == fileSpec->deadline || !fileSpec->isDue || 0 == fileSpec->isAccessible ||
+            fileSpec->useMmap || fileSpec->isUnchanged)
+        {
+            continue;
+        }
+        if (NULL == fileSpec->reader)
+        {
+            if (NULL != openFileDescriptor(fileSpec))
+            {
+                fileSpec->reader = deadlineread_create(fileno(fileSpec->fileDescriptor));
+            }
+            if (NULL == fileSpec->reader)
+            {
+                log_error_string("Could not start a reader for file \"%s\", reading it without "
+                                 "deadline.",
+                                 fileSpec->filename);
+                fileSpec->deadline = 0;
+                continue;
+            }
+        }
+        if (0 < fileSpec->binaryDefinitions->length &&
+            fileSpec->plannedColumns != fileSpec->binaryColumns && planBinaryRanges(fileSpec))
+        {
+            log_error("Could not allocate memory for reading binary values.");
+            continue;
+        }
+        int rangeCount = (0 < fileSpec->binaryDefinitions->length) ? fileSpec->binaryRangeCount : 0;
+        if (deadlineRangesReserve < rangeCount)
+        {
+            struct deadline_read_range* reallocRanges =
+                realloc(deadlineRanges, rangeCount * sizeof(struct deadline_read_range));
+            if (NULL == reallocRanges)
+            {
+                continue;
+            }
+            deadlineRanges = reallocRanges;
+            deadlineRangesReserve = rangeCount;
+        }
+        size_t rangeBufLength = 0;
+        for (int j = 0; j < rangeCount; ++j)
+        {
+            struct binaryRange* range = fileSpec->binaryRanges + j;
+            deadlineRanges[j].offset = range->offset;
+            deadlineRanges[j].length = range->length;
+            deadlineRanges[j].bufOffset = range->bufOffset;
+            deadlineRanges[j].bytesRead = 0;
+            rangeBufLength = range->bufOffset + range->length;
+        }
+        fileSpec->readPosted =
+            (0 == deadlineread_post(fileSpec->reader, 0 < fileSpec->dataDefinitions->length,
+                                    deadlineRanges, rangeCount, rangeBufLength));
+    }
+}
 
-    if (NULL == curDatatypeName || 0 == strcasecmp(curDatatypeName, "int"))
+/**
+ * Waits until the read posted for a file with a deadline completed or its deadline passed, and
+ * hands the read content over to parseWholeFile
+ *
+ * @return Returns 0 if the file can be sampled, a value greater than that if it missed its deadline
+ */
+static int awaitDeadlineRead(struct fileParams* fileSpec, uint64_t cycleStart)
+{
+    if (0 == fileSpec->deadline || NULL == fileSpec->reader || fileSpec->useMmap ||
+        fileSpec->isUnchanged)
     {
-        curDatatype = SCOREP_METRIC_VALUE_INT64;
+        return 0;
     }
-    else if (0 == strcasecmp(curDatatypeName, "int_hex"))
+    if (!fileSpec->readPosted ||
+        deadlineread_wait(fileSpec->reader, cycleStart + (uint64_t)fileSpec->deadline * 1000))
     {
-        curDatatype = SCOREP_METRIC_VALUE_INT64;
-        *inputHex = 1;
+        if (0 == fileSpec->deadlineMisses)
+        {
+            log_error_string("File \"%s\" missed its read deadline, its samples are missing "
+                             "until the read returns.",
+                             fileSpec->filename);
+        }
+        ++fileSpec->deadlineMisses;
+        ++deadlineMissCount;
+        return 1;
     }
-    else if (0 == strcasecmp(curDatatypeName, "uint"))
+    __atomic_fetch_add(&cycleBytesRead, deadlineread_bytes_read(fileSpec->reader),
+                       __ATOMIC_RELAXED);
+    uint64_t readStart, readEnd;
+    deadlineread_read_time(fileSpec->reader, &readStart, &readEnd);
+    noteRead(fileSpec, readStart, readEnd);
+    if (0 < fileSpec->dataDefinitions->length)
     {
-        curDatatype = SCOREP_METRIC_VALUE_UINT64;
+        fileSpec->prefetchLength = deadlineread_swap_content(
+            fileSpec->reader, &fileSpec->prefetchBuf, &fileSpec->prefetchReserve);
     }
-    else if (0 == strcasecmp(curDatatypeName, "uint_hex"))
+    if (0 < fileSpec->binaryDefinitions->length)
     {
-        curDatatype = SCOREP_METRIC_VALUE_UINT64;
-        *inputHex = 1;
+        const struct deadline_read_range* ranges = NULL;
+        const char* rangeBuf = deadlineread_ranges(fileSpec->reader, &ranges);
+        for (int i = 0; i < fileSpec->binaryRangeCount; ++i)
+        {
+            struct binaryRange* range = fileSpec->binaryRanges + i;
+            range->bytesRead = ranges[i].bytesRead;
+            if (0 < range->bytesRead)
+            {
+                memcpy(fileSpec->binaryBuf + range->bufOffset, rangeBuf + range->bufOffset,
+                       range->bytesRead);
+            }
+        }
+        fileSpec->binaryPrefetched = true;
     }
-    else if (0 == strcasecmp(curDatatypeName, "float") ||
-             0 == strcasecmp(curDatatypeName, "double"))
+    return 0;
+}
+
+/**
+ * Merges the byte ranges of the binary values of a file, in the order of its binaryColumns, i.e.
+ * sorted by their offset, into as few ranges as possible. Values not further apart than
+ * BINARY_MERGE_GAP bytes share a range, as reading a few bytes more is cheaper than another
+ * syscall. The ranges refer to the values by their index in the columns, so they are only planned
+ * for columns that were built.
+ *
+ * @return Returns 0 on success, a value greater than that on error
+ */
+static int planBinaryRanges(struct fileParams* fileSpec)
+{
+    const struct binaryColumns* columns = fileSpec->binaryColumns;
+    int count = (NULL != columns) ? columns->count : 0;
+    if (0 == count)
     {
-        curDatatype = SCOREP_METRIC_VALUE_DOUBLE;
+        fileSpec->binaryRangeCount = 0;
+        fileSpec->plannedColumns = columns;
+        return 0;
     }
-    else if (0 == strcasecmp(curDatatypeName, "int8_bin"))
+    struct binaryRange* ranges =
+        realloc(fileSpec->binaryRanges, count * sizeof(struct binaryRange));
+    if (NULL == ranges)
     {
-        *binaryDatatype = FILEPARSER_BINARY_DATATYPE_INT8;
-        *inputBinaryWidth = 1;
-        curDatatype = SCOREP_METRIC_VALUE_INT64;
+        return 1;
     }
-    else if (0 == strcasecmp(curDatatypeName, "int16_bin"))
+    fileSpec->binaryRanges = ranges;
+    int rangeCount = 0;
+    size_t bufLength = 0;
+    for (int i = 0; i < count; ++i)
     {
-        *binaryDatatype = FILEPARSER_BINARY_DATATYPE_INT16;
-        *inputBinaryWidth = 2;
-        curDatatype = SCOREP_METRIC_VALUE_INT64;
+        struct varParams* varSpec = columns->varSpecs[i];
+        uint64_t valueEnd = varSpec->binaryOffset + varSpec->inputBinaryWidth;
+        if (varSpec->arrayHead == varSpec)
+        {
+            /* the range of the head covers the whole array, so it is read at once */
+            valueEnd += (varSpec->arrayCount - 1) * varSpec->arrayStride;
+        }
+        struct binaryRange* curRange = (0 < rangeCount) ? ranges + rangeCount - 1 : NULL;
+        if (NULL != curRange &&
+            varSpec->binaryOffset <= curRange->offset + curRange->length + BINARY_MERGE_GAP)
+        {
+            if (valueEnd > curRange->offset + curRange->length)
+            {
+                bufLength += valueEnd - (curRange->offset + curRange->length);
+                curRange->length = valueEnd - curRange->offset;
+            }
+            ++curRange->definitionCount;
+        }
+        else
+        {
+            curRange = ranges + rangeCount;
+            curRange->offset = varSpec->binaryOffset;
+            curRange->length = varSpec->inputBinaryWidth;
+            curRange->bufOffset = bufLength;
+            curRange->bytesRead = 0;
+            curRange->firstDefinition = i;
+            curRange->definitionCount = 1;
+            bufLength += curRange->length;
+            ++rangeCount;
+        }
     }
-    else if (0 == strcasecmp(curDatatypeName, "int32_bin"))
+    char* reallocBuf = realloc(fileSpec->binaryBuf, bufLength);
+    if (NULL == reallocBuf)
+    {
+        return 2;
+    }
+    fileSpec->binaryBuf = reallocBuf;
+    fileSpec->binaryRangeCount = rangeCount;
+    fileSpec->plannedColumns = columns;
+    return 0;
+}
+
+/**
+ * Reads the bytes of all binary ranges of a file, a single pread per range
+ */
+static void readBinaryRanges(struct fileParams* fileSpec)
+{
+    if (fileSpec->plannedColumns != fileSpec->binaryColumns && planBinaryRanges(fileSpec))
     {
-        *binaryDatatype = FILEPARSER_BINARY_DATATYPE_INT32;
-        *inputBinaryWidth = 4;
-        curDatatype = SCOREP_METRIC_VALUE_INT64;
+        log_error("Could not allocate memory for reading binary values.");
+        fileSpec->binaryRangeCount = 0;
+        fileSpec->plannedColumns = NULL;
+        return;
     }
-    else if (0 == strcasecmp(curDatatypeName, "int64_bin"))
+    int fd = fileno(fileSpec->fileDescriptor);
+    for (int i = 0; i < fileSpec->binaryRangeCount; ++i)
     {
-        *binaryDatatype = FILEPARSER_BINARY_DATATYPE_INT64;
-        *inputBinaryWidth = 8;
-        curDatatype = SCOREP_METRIC_VALUE_INT64;
+        struct binaryRange* range = fileSpec->binaryRanges + i;
+        range->bytesRead = 0;
+        /* some files deliver less bytes than requested at once, keep reading until EOF */
+        while ((size_t)range->bytesRead < range->length)
+        {
+            ssize_t readReturn =
+                pread(fd, fileSpec->binaryBuf + range->bufOffset + range->bytesRead,
+                      range->length - range->bytesRead, range->offset + range->bytesRead);
+            if (0 >= readReturn)
+            {
+                break;
+            }
+            range->bytesRead += readReturn;
+            __atomic_fetch_add(&cycleBytesRead, readReturn, __ATOMIC_RELAXED);
+        }
     }
-    else if (0 == strcasecmp(curDatatypeName, "uint8_bin"))
+}
+
+/**
+ * Maps a file into memory, if that did not happen yet. A single stat of the path tells whether the
+ * file changed its size or was replaced since it was mapped, in which case it is mapped again, so
+ * neither a truncated nor a stale file is parsed from the mapping.
+ *
+ * @return Returns 0 on success, a value greater than that on error
+ */
+static int mapFile(struct fileParams* fileSpec)
+{
+    if (fileSpec->plannedColumns != fileSpec->binaryColumns && planBinaryRanges(fileSpec))
     {
-        *binaryDatatype = FILEPARSER_BINARY_DATATYPE_UINT8;
-        *inputBinaryWidth = 1;
-        curDatatype = SCOREP_METRIC_VALUE_UINT64;
+        return 1;
     }
-    else if (0 == strcasecmp(curDatatypeName, "uint16_bin"))
+    struct stat fileInfo;
+    if (0 != stat(fileSpec->filename, &fileInfo))
     {
-        *binaryDatatype = FILEPARSER_BINARY_DATATYPE_UINT16;
-        *inputBinaryWidth = 2;
-        curDatatype = SCOREP_METRIC_VALUE_UINT64;
+        return 2;
     }
-    else if (0 == strcasecmp(curDatatypeName, "uint32_bin"))
+    if (NULL != fileSpec->mapping)
     {
-        *binaryDatatype = FILEPARSER_BINARY_DATATYPE_UINT32;
-        *inputBinaryWidth = 4;
-        curDatatype = SCOREP_METRIC_VALUE_UINT64;
+        bool sameFile = (fileInfo.st_ino == fileSpec->mappingInode &&
+                         fileInfo.st_dev == fileSpec->mappingDevice);
+        if (sameFile && (size_t)fileInfo.st_size == fileSpec->mappingLength)
+        {
+            /* values beyond the end of the file are skipped */
+            return 0;
+        }
+        munmap(fileSpec->mapping, fileSpec->mappingLength);
+        fileSpec->mapping = NULL;
+        if (!sameFile && NULL != fileSpec->fileDescriptor)
+        {
+            /* the path refers to a new file now, reopen it */
+            fclose(fileSpec->fileDescriptor);
+            fileSpec->fileDescriptor = NULL;
+        }
     }
-    else if (0 == strcasecmp(curDatatypeName, "uint64_bin"))
+    if (NULL == openFileDescriptor(fileSpec))
     {
-        *binaryDatatype = FILEPARSER_BINARY_DATATYPE_UINT64;
-        *inputBinaryWidth = 8;
-        curDatatype = SCOREP_METRIC_VALUE_UINT64;
+        return 2;
     }
-    else if (0 == strcasecmp(curDatatypeName, "float_bin"))
+    /* the descriptor decides what is mapped, the path may have been replaced again meanwhile */
+    int fd = fileno(fileSpec->fileDescriptor);
+    if (0 != fstat(fd, &fileInfo) || 0 == fileInfo.st_size)
     {
-        *binaryDatatype = FILEPARSER_BINARY_DATATYPE_FLOAT;
-        *inputBinaryWidth = 4;
-        curDatatype = SCOREP_METRIC_VALUE_DOUBLE;
+        return 3;
     }
-    else if (0 == strcasecmp(curDatatypeName, "double_bin"))
+    void* mapping = mmap(NULL, fileInfo.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    if (MAP_FAILED == mapping)
     {
-        *binaryDatatype = FILEPARSER_BINARY_DATATYPE_DOUBLE;
-        *inputBinaryWidth = 8;
-        curDatatype = SCOREP_METRIC_VALUE_DOUBLE;
+        log_error_string("Could not map file \"%s\" into memory.", fileSpec->filename);
+        return 4;
     }
-    else
+    fileSpec->mapping = mapping;
+    fileSpec->mappingLength = fileInfo.st_size;
+    fileSpec->mappingDevice = fileInfo.st_dev;
+    fileSpec->mappingInode = fileInfo.st_ino;
+    if (-1 != fileSpec->seqlockOffset &&
+        (0 != fileSpec->seqlockOffset % sizeof(uint64_t) ||
+         (size_t)fileSpec->seqlockOffset + sizeof(uint64_t) > fileSpec->mappingLength))
     {
-        log_error_string("Could not parse datatype \"%s\".", curDatatypeName);
+        log_error_string("The sequence word of file \"%s\" is not an aligned 64-bit word within "
+                         "the file, reading it without seqlock.",
+                         fileSpec->filename);
+        fileSpec->seqlockOffset = -1;
     }
-
-    return curDatatype;
+    return 0;
 }
 
 /**
- * Parses a whole file according to parameters given with fileSpec and returns an array of found
- * results "Files öffnen und schliessen ist immer sehr teuer" (Robert Schöne) DONE: declare the used
- * variables as static, thereby they will be kept as global variables (within the file; even when I
- * declare them within a method to be static) of course this also means I will have to allocate them
- * at the beginning and have to free them at the end
+ * Copies the bytes of all binary ranges of a mapped file to binaryBuf. If the file is guarded by a
+ * seqlock, the copy is retried until the sequence word was even and unchanged while copying, so
+ * all values of the file are consistent with each other.
  */
-static struct Vector* parseWholeFile(struct fileParams* fileSpec, bool verbose)
+static void copyBinaryRangesFromMapping(struct fileParams* fileSpec)
 {
-
-    /* Try to get a file descriptor pointing to the beginning of the file */
-    FILE* fileDescriptor = prepareFileDescriptorForParsing(fileSpec);
-    if (NULL == fileDescriptor || 0 == fileSpec->isAccessible)
+    const uint64_t* sequenceWord = NULL;
+    if (-1 != fileSpec->seqlockOffset)
     {
-        return NULL;
-    }
-
-    struct Vector* foundValuesVec = vec_create(fileSpec->dataDefinitions->length);
-    if (NULL == foundValuesVec)
-    {
-        log_error("Could not allocate vector to store the values found in a file.");
-        return NULL;
-    }
-
-    size_t readReturn = -1;
-    char* overlapBuf = NULL;
-    char* overlapSwapBuf = NULL;
-    char* curNewlineIndex = NULL;
-    char* prevIndex = NULL;
-    int curLineNumber = 0;
-    int varParamsIndex = 0;
-    int binaryParamsIndex = 0;
-    uint64_t curTotalBytesRead = 0;
-    char* binaryOverlapBuf = NULL;
-
-    if (0 == fileSpec->binaryDefinitions->length)
-    {
-        binaryParamsIndex = -1;
+        sequenceWord = (const uint64_t*)(fileSpec->mapping + fileSpec->seqlockOffset);
     }
-    do
+    for (int attempt = 0; attempt < SEQLOCK_MAX_RETRIES; ++attempt)
     {
-        /* do read from file */
-        readReturn = fread(readBuf, 1, DEFAULT_BUFSIZE - 1, fileDescriptor);
-        if (0 < readReturn)
+        uint64_t sequenceBefore = 0;
+        if (NULL != sequenceWord)
         {
-            curTotalBytesRead += readReturn;
-            readBuf[readReturn] = '\0';
-
-            /* check if there are binary reads within this chunk of read bytes to be performed */
-            if (-1 < binaryParamsIndex)
-            {
-                struct varParams* binaryVarSpec =
-                    fileSpec->binaryDefinitions->data[binaryParamsIndex];
-                while (NULL != binaryVarSpec && binaryVarSpec->binaryOffset < curTotalBytesRead)
-                {
-                    if (NULL != binaryOverlapBuf)
-                    {
-                        /* copy both the fragment of old bytes and freshly read bytes to
-                         * binaryBytesForParsing */
-                        memcpy(binaryBytesForParsing, binaryOverlapBuf,
-                               curTotalBytesRead - readReturn - binaryVarSpec->binaryOffset);
-                        int byteCountStillToCopy =
-                            binaryVarSpec->inputBinaryWidth -
-                            (curTotalBytesRead - readReturn - binaryVarSpec->binaryOffset);
-                        memcpy(binaryBytesForParsing + byteCountStillToCopy, readBuf,
-                               byteCountStillToCopy);
-
-                        /* actually register the read bytes */
-                        tryAppendingValueToFoundValuesVec(fileSpec, binaryVarSpec, foundValuesVec,
-                                                          binaryBytesForParsing);
-                        free(binaryOverlapBuf);
-                    }
-                    else
-                    {
-                        /* is binaryOffset within the current readBuf? */
-                        if (binaryVarSpec->binaryOffset > (curTotalBytesRead - readReturn))
-                        {
-                            if ((binaryVarSpec->binaryOffset + binaryVarSpec->inputBinaryWidth) <=
-                                curTotalBytesRead)
-                            {
-                                /* copy the found bytes for appending them to foundValues later */
-                                memcpy(binaryBytesForParsing,
-                                       readBuf + (binaryVarSpec->binaryOffset -
-                                                  (curTotalBytesRead - readReturn)),
-                                       binaryVarSpec->inputBinaryWidth);
-                                tryAppendingValueToFoundValuesVec(
-                                    fileSpec, binaryVarSpec, foundValuesVec, binaryBytesForParsing);
-                            }
-                            else
-                            {
-                                /* the current readBuf does not contain all bytes that we wish to
-                                 * read, utilize binaryOverlapBuf */
-                                binaryOverlapBuf = calloc(8, sizeof(char));
-                                if (NULL != binaryOverlapBuf)
-                                {
-                                    memcpy(binaryOverlapBuf,
-                                           readBuf + (binaryVarSpec->binaryOffset -
-                                                      (curTotalBytesRead - readReturn)),
-                                           curTotalBytesRead - binaryVarSpec->binaryOffset);
-                                }
-                                else
-                                {
-                                    log_error("Could not read binary value, allocation of 8 bytes "
-                                              "failed.");
-                                }
-                                continue;
-                            }
-                        }
-                        else
-                        {
-                            log_error("This error should never appear. binaryVarSpec->binaryOffset "
-                                      "is smaller than (curTotalBytesRead - readReturn).");
-                        }
-                    }
-
-                    /* incremental operation, the usual loop stuff */
-                    ++binaryParamsIndex;
-                    if (fileSpec->binaryDefinitions->length > binaryParamsIndex)
-                    {
-                        binaryVarSpec = fileSpec->binaryDefinitions->data[binaryParamsIndex];
-                    }
-                    else
-                    {
-                        binaryVarSpec = NULL;
-                    }
-                }
-            }
-
-            curNewlineIndex = strchr(readBuf, '\n');
-            /* if no newline was found in the current read out, then append it all to overlapBuf */
-            if (NULL == curNewlineIndex)
+            sequenceBefore = __atomic_load_n(sequenceWord, __ATOMIC_ACQUIRE);
+            if (sequenceBefore & 1)
             {
-                if (NULL == overlapBuf)
-                {
-                    overlapBuf = "";
-                }
-                overlapSwapBuf = malloc(strlen(overlapBuf) + readReturn + 1);
-                if (NULL == overlapSwapBuf)
-                {
-                    log_error("Could not allocate memory for storing the read from readBuf.");
-                    free(overlapBuf);
-                    vec_destroy(foundValuesVec);
-                    return NULL;
-                }
-                sprintf(overlapSwapBuf, "%s%s", overlapBuf, readBuf);
-                overlapBuf = overlapSwapBuf;
+                /* a writer is updating the values right now, give it a chance to finish */
+                sched_yield();
+                continue;
             }
-            else
+        }
+        for (int i = 0; i < fileSpec->binaryRangeCount; ++i)
+        {
+            struct binaryRange* range = fileSpec->binaryRanges + i;
+            range->bytesRead = 0;
+            if (range->offset < fileSpec->mappingLength)
             {
-                /* we found a newline in the current read out, thus we can process it */
-                prevIndex = readBuf;
-
-                /* overlapBuf is not empty, i.e. last call to read did not end with a newline */
-                if (NULL != overlapBuf)
-                {
-                    curNewlineIndex[0] = '\0';
-
-                    /* try allocating some memory for the current line */
-                    int tempLen = strlen(overlapBuf) + strlen(readBuf) + 1;
-                    overlapSwapBuf = malloc(tempLen);
-                    if (NULL == overlapSwapBuf)
-                    {
-                        log_error(
-                            "Could not allocate memory for parsing the current line in a file.");
-                        free(overlapBuf);
-                        vec_destroy(foundValuesVec);
-                        return NULL;
-                    }
-                    sprintf(overlapSwapBuf, "%s%s", overlapBuf, readBuf);
-                    free(overlapBuf);
-                    overlapBuf = overlapSwapBuf;
-
-                    processLine(fileSpec, &varParamsIndex, curLineNumber, foundValuesVec,
-                                overlapBuf, verbose);
-                    ++curLineNumber;
-
-                    /* a bit of cleanup */
-                    free(overlapBuf);
-                    overlapBuf = NULL;
-                    prevIndex = curNewlineIndex + 1;
-                    curNewlineIndex = strchr(curNewlineIndex + 1, '\n');
-                }
-                /* go through readBuf processing each line */
-                for (; NULL != curNewlineIndex; curNewlineIndex = strchr(curNewlineIndex + 1, '\n'))
-                {
-                    curNewlineIndex[0] = '\0';
-                    processLine(fileSpec, &varParamsIndex, curLineNumber, foundValuesVec,
-                                prevIndex, verbose);
-                    ++curLineNumber;
-
-                    prevIndex = curNewlineIndex + 1;
-                }
-                /* process remainder/trailing line, put it in overlapBuf */
-                if ((readBuf + readReturn) > prevIndex)
+                range->bytesRead = fileSpec->mappingLength - range->offset;
+                if ((size_t)range->bytesRead > range->length)
                 {
-                    overlapBuf = strdup(prevIndex);
+                    range->bytesRead = range->length;
                 }
+                memcpy(fileSpec->binaryBuf + range->bufOffset, fileSpec->mapping + range->offset,
+                       range->bytesRead);
             }
         }
-
-    } while (0 < readReturn);
-
-    /* process last line */
-    if (NULL != overlapBuf)
+        if (NULL == sequenceWord)
+        {
+            return;
+        }
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (sequenceBefore == __atomic_load_n(sequenceWord, __ATOMIC_RELAXED))
+        {
+            return;
+        }
+        sched_yield();
+    }
+    /* no consistent copy could be taken, skip the values this time */
+    for (int i = 0; i < fileSpec->binaryRangeCount; ++i)
     {
-        processLine(fileSpec, &varParamsIndex, curLineNumber, foundValuesVec, overlapBuf, verbose);
-        ++curLineNumber;
-        free(overlapBuf);
+        fileSpec->binaryRanges[i].bytesRead = 0;
     }
-
-    return foundValuesVec;
 }
+
 /**
- * Tries to get a file Descriptor for the file denoted in varParams, if a fileDescriptor is already
- * there, seek to beginning of file
+ * Parses the binary values from the bytes read by readBinaryRanges, values beyond the end of the
+ * file are skipped
  */
-static FILE* prepareFileDescriptorForParsing(struct fileParams* fileSpec)
+static void extractBinaryValues(struct fileParams* fileSpec, struct Vector* foundValuesVec)
 {
-    /* try getting a valid file descriptor */
-    FILE* fileDescriptor = fileSpec->fileDescriptor;
-    if (NULL == fileDescriptor)
+    /* the ranges index the columns they were planned for */
+    const struct binaryColumns* columns = fileSpec->plannedColumns;
+    if (NULL == columns)
     {
-        if (NULL != fileSpec->filename)
-        {
-            /* try opening the file */
-            fileDescriptor = fopen(fileSpec->filename, "r");
-            if (NULL == fileDescriptor)
-            {
-                return NULL;
-            }
-            else
-            {
-                fileSpec->fileDescriptor = fileDescriptor;
-            }
-        }
-        else
-        {
-            return NULL;
-        }
+        return;
     }
-    else
+    for (int i = 0; i < fileSpec->binaryRangeCount; ++i)
     {
-        /* try to seek to the beginning of the file */
-        int newOffset = fseek(fileDescriptor, 0, SEEK_SET);
-        if (-1 == newOffset)
+        struct binaryRange* range = fileSpec->binaryRanges + i;
+        for (int j = range->firstDefinition; j < range->firstDefinition + range->definitionCount;
+             ++j)
         {
-            /* if seeking fails, do close and open the file again */
-            log_error("Failed to reset the read offset using fseek.");
-            fprintf(stderr, "File \"%s\" is affected. errno = %d\n", fileSpec->filename, errno);
-            fclose(fileDescriptor);
-            fileDescriptor = fopen(fileSpec->filename, "r");
-            if (NULL == fileDescriptor)
+            uint64_t offsetInRange = columns->binaryOffset[j] - range->offset;
+            if (columns->isArrayElement[j])
             {
-                return NULL;
+                struct varParams* varSpec = columns->varSpecs[j];
+                struct varParams* head = varSpec->arrayHead;
+                /* the head comes first and parses all elements of the array in one go */
+                if (head == varSpec)
+                {
+                    int validCount = 0;
+                    if (offsetInRange + head->inputBinaryWidth <= (uint64_t)range->bytesRead)
+                    {
+                        validCount = 1 + (range->bytesRead - offsetInRange - head->inputBinaryWidth) /
+                                             head->arrayStride;
+                    }
+                    if (validCount > head->arrayCount)
+                    {
+                        validCount = head->arrayCount;
+                    }
+                    parseValuesBinaryStrided(fileSpec->binaryBuf + range->bufOffset + offsetInRange,
+                                             validCount, head->arrayStride, head->binaryDatatype,
+                                             head->swapBytes, head->arrayValues);
+                    head->arrayValidCount = validCount;
+                }
+                if (varSpec->arrayIndex < head->arrayValidCount)
+                {
+                    tryAppendingParsedValueToFoundValuesVec(fileSpec, varSpec, foundValuesVec,
+                                                            head->arrayValues[varSpec->arrayIndex]);
+                }
+                continue;
             }
-            else
+            if (offsetInRange + columns->inputBinaryWidth[j] <= (uint64_t)range->bytesRead)
             {
-                fileSpec->fileDescriptor = fileDescriptor;
+                /* a value at the same offset with the same encoding is parsed only once */
+                uint64_t value = 0;
+                if (j > range->firstDefinition && !columns->isArrayElement[j - 1] &&
+                    columns->binaryOffset[j - 1] == columns->binaryOffset[j] &&
+                    columns->inputBinaryWidth[j - 1] == columns->inputBinaryWidth[j] &&
+                    columns->binaryDatatype[j - 1] == columns->binaryDatatype[j] &&
+                    0 < foundValuesVec->length &&
+                    ((struct foundValue*)foundValuesVec->data[foundValuesVec->length - 1])
+                            ->associatedVarParams == columns->varSpecs[j - 1])
+                {
+                    value = ((struct foundValue*)foundValuesVec->data[foundValuesVec->length - 1])
+                                ->associatedValue;
+                }
+                else
+                {
+                    value = parseValueBinary(fileSpec->binaryBuf + range->bufOffset + offsetInRange,
+                                             columns->inputBinaryWidth[j],
+                                             columns->binaryDatatype[j]);
+                }
+                tryAppendingParsedValueToFoundValuesVec(fileSpec, columns->varSpecs[j],
+                                                        foundValuesVec, value);
             }
         }
     }
-
-    return fileDescriptor;
 }
 
 /**
  * Part of parseWholeFile, just process a line, adding the values of found field matches to the
  * result Vector foundValuesVec
  */
-static void processLine(struct fileParams* fileSpec, int* varParamsIndex, int curLineNumber,
-                        struct Vector* foundValuesVec, char* myLine, bool verbose)
+static void processLine(struct fileParams* fileSpec, const struct textColumns* columns,
+                        int* varParamsIndex, int curLineNumber, struct Vector* foundValuesVec,
+                        char* myLine, bool verbose)
 {
-    if (NULL == fileSpec || NULL == fileSpec->dataDefinitions || NULL == foundValuesVec)
-    {
-        return;
-    }
-    if (*varParamsIndex >= fileSpec->dataDefinitions->length)
+    if (NULL == fileSpec || NULL == columns || NULL == foundValuesVec)
     {
         return;
     }
-    struct varParams* curVarSpec =
-        (struct varParams*)fileSpec->dataDefinitions->data[*varParamsIndex];
+    int i = *varParamsIndex;
 
-    while (NULL != curVarSpec && curLineNumber == curVarSpec->posRow)
+    /* the varParams of a row are sorted by separator and column, thus the line is tokenized once
+     * per separator and a field wanted by several varParams is parsed once per datatype */
+    while (i < columns->count && curLineNumber == columns->posRow[i])
     {
         char separator[] = { 0, 0 };
-        separator[0] = curVarSpec->posSep;
+        separator[0] = columns->posSep[i];
         char* lineDupForStrtok = strdup(myLine);
+        if (NULL == lineDupForStrtok)
+        {
+            log_error("Could not allocate memory for tokenizing a line.");
+            break;
+        }
         char* nextToken = NULL;
         char* curToken = strtok_r(lineDupForStrtok, separator, &nextToken);
         int curColumnIndex = 0;
-        while (NULL != curToken)
+        int prev = -1;
+        uint64_t prevValue = 0;
+        while (i < columns->count && curLineNumber == columns->posRow[i] &&
+               separator[0] == columns->posSep[i])
         {
-
-            if (curColumnIndex == curVarSpec->posCol)
+            while (NULL != curToken && curColumnIndex < columns->posCol[i])
             {
-                tryAppendingValueToFoundValuesVec(fileSpec, curVarSpec, foundValuesVec, curToken);
-                break;
+                curToken = strtok_r(NULL, separator, &nextToken);
+                ++curColumnIndex;
             }
-
-            curToken = strtok_r(NULL, separator, &nextToken);
-            ++curColumnIndex;
-        }
-        if(verbose)
-        {
-            if(NULL == curToken && curColumnIndex <= curVarSpec->posCol)
+            if (NULL != curToken)
             {
-                log_error_string("Could not read metric \"%s\", not enough columns in line", curVarSpec->name);
+                uint64_t value = prevValue;
+                if (0 > prev || columns->posCol[prev] != columns->posCol[i] ||
+                    columns->datatype[prev] != columns->datatype[i] ||
+                    columns->inputHex[prev] != columns->inputHex[i])
+                {
+                    value = parseValue(curToken, columns->datatype[i], columns->inputHex[i]);
+                }
+                tryAppendingParsedValueToFoundValuesVec(fileSpec, columns->varSpecs[i],
+                                                        foundValuesVec, value);
+                prev = i;
+                prevValue = value;
             }
-        }
-        *varParamsIndex = *varParamsIndex + 1;
-        if (*varParamsIndex < fileSpec->dataDefinitions->length)
-        {
-            curVarSpec = (struct varParams*)fileSpec->dataDefinitions->data[*varParamsIndex];
-        }
-        else
-        {
-            curVarSpec = NULL;
+            else if (verbose)
+            {
+                log_error_string("Could not read metric \"%s\", not enough columns in line",
+                                 columns->varSpecs[i]->name);
+            }
+            ++i;
         }
         free(lineDupForStrtok);
     }
+    *varParamsIndex = i;
 }
 
 /**
- * This function simply tries to append a freshly read out value to the resultset foundValuesVec
+ * Appends an already parsed value to the resultset foundValuesVec
  */
-static void tryAppendingValueToFoundValuesVec(struct fileParams* fileSpec,
-                                              struct varParams* varSpec,
-                                              struct Vector* foundValuesVec, char* foundStr)
+static void tryAppendingParsedValueToFoundValuesVec(struct fileParams* fileSpec,
+                                                    struct varParams* varSpec,
+                                                    struct Vector* foundValuesVec, uint64_t value)
 {
     struct foundValue* found = calloc(1, sizeof(struct foundValue));
     if (NULL != found)
     {
 		found->associatedVarParams = varSpec;
 		found->associatedFileParams = fileSpec;
-		if (0 < varSpec->inputBinaryWidth)
-		{
-			found->associatedValue =
-					parseValueBinary(foundStr, varSpec->inputBinaryWidth, varSpec->binaryDatatype);
-		}
-		else
-		{
-			found->associatedValue = parseValue(foundStr, varSpec->datatype, varSpec->inputHex);
-		}
+		found->associatedValue = value;
 		if (vec_append(foundValuesVec, found))
 		{
 			log_error("Could not append read value to foundValuesVec, insufficient memory.");
@@ -1395,7 +4947,23 @@ SCOREP_METRIC_PLUGIN_ENTRY(fileparser_plugin)
     info.plugin_version = SCOREP_METRIC_PLUGIN_VERSION;
     info.run_per = SCOREP_METRIC_PER_HOST;
     info.sync = SCOREP_METRIC_ASYNC;
+    /* unless an interval is given, Score-P collects the values only once at the end */
     info.delta_t = UINT64_MAX;
+    char* from_env = getenv("SCOREP_METRIC_FILEPARSER_PLUGIN_DELTA_T");
+    if (NULL != from_env)
+    {
+        char* end = NULL;
+        unsigned long long deltaT = strtoull(from_env, &end, 10);
+        if (end != from_env && '\0' == *end && 0 < deltaT)
+        {
+            info.delta_t = deltaT;
+        }
+        else
+        {
+            log_error_string("Ignoring malformed SCOREP_METRIC_FILEPARSER_PLUGIN_DELTA_T \"%s\"",
+                             from_env);
+        }
+    }
     info.initialize = init;
     info.finalize = fini;
     /* define callbacks */
@@ -0,0 +1,150 @@
+/*
+ * hash_map.c
+ *
+ *  Created on: 19.10.2026
+ */
+#include "hash_map.h"
+
+/* required for datatype uint64_t */
+#include <stdint.h>
+/* required for calloc, free */
+#include <stdlib.h>
+/* required for strcmp */
+#include <string.h>
+
+/**
+ * FNV-1a hash of a string
+ */
+static uint64_t hashString(const char* key)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for (; '\0' != *key; ++key)
+    {
+        hash ^= (unsigned char)*key;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+/**
+ * Returns the slot holding key, or the empty slot where key would be inserted
+ */
+static int findSlot(const struct HashMap* map, const char* key)
+{
+    int mask = map->reserve - 1;
+    int slot = hashString(key) & mask;
+    while (NULL != map->keys[slot] && 0 != strcmp(map->keys[slot], key))
+    {
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+/**
+ * Moves all keys into newly allocated slots, slotCount has to be a power of two
+ *
+ * @return Returns 0 on success, a value greater than that on error
+ */
+static int rehash(struct HashMap* map, int slotCount)
+{
+    const char** oldKeys = map->keys;
+    void** oldValues = map->values;
+    int oldReserve = map->reserve;
+    map->keys = calloc(slotCount, sizeof(const char*));
+    map->values = calloc(slotCount, sizeof(void*));
+    if (NULL == map->keys || NULL == map->values)
+    {
+        free(map->keys);
+        free(map->values);
+        map->keys = oldKeys;
+        map->values = oldValues;
+        return 1;
+    }
+    map->reserve = slotCount;
+    for (int i = 0; i < oldReserve; ++i)
+    {
+        if (NULL != oldKeys[i])
+        {
+            int slot = findSlot(map, oldKeys[i]);
+            map->keys[slot] = oldKeys[i];
+            map->values[slot] = oldValues[i];
+        }
+    }
+    free(oldKeys);
+    free(oldValues);
+    return 0;
+}
+
+struct HashMap* hashmap_create(int initialCapacity)
+{
+    struct HashMap* newMap = calloc(1, sizeof(struct HashMap));
+    if (NULL == newMap)
+    {
+        return NULL;
+    }
+    if (hashmap_reserve(newMap, (1 > initialCapacity) ? 1 : initialCapacity))
+    {
+        free(newMap);
+        return NULL;
+    }
+    return newMap;
+}
+
+void* hashmap_get(struct HashMap* map, const char* key)
+{
+    if (NULL == map || NULL == key)
+    {
+        return NULL;
+    }
+    return map->values[findSlot(map, key)];
+}
+
+int hashmap_put(struct HashMap* map, const char* key, void* value)
+{
+    if (NULL == map || NULL == key)
+    {
+        return 1;
+    }
+    if (hashmap_reserve(map, map->length + 1))
+    {
+        return 2;
+    }
+    int slot = findSlot(map, key);
+    if (NULL == map->keys[slot])
+    {
+        map->keys[slot] = key;
+        ++(map->length);
+    }
+    map->values[slot] = value;
+    return 0;
+}
+
+int hashmap_reserve(struct HashMap* map, int capacity)
+{
+    if (NULL == map)
+    {
+        return 1;
+    }
+    /* keep the load factor at most 1/2, so probe sequences stay short */
+    int slotCount = (0 < map->reserve) ? map->reserve : 8;
+    while (slotCount < 2 * capacity)
+    {
+        slotCount *= 2;
+    }
+    if (slotCount > map->reserve && rehash(map, slotCount))
+    {
+        return 2;
+    }
+    return 0;
+}
+
+void hashmap_destroy(struct HashMap* map)
+{
+    if (NULL == map)
+    {
+        return;
+    }
+    free(map->keys);
+    free(map->values);
+    free(map);
+}
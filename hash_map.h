@@ -0,0 +1,52 @@
+/*
+ * hash_map.h
+ *
+ *  Created on: 19.10.2026
+ */
+
+#ifndef HASH_MAP_H_
+#define HASH_MAP_H_
+
+/* A map from strings to pointers of any kind, using open addressing. The keys are not copied, they
+ * have to stay valid as long as they are in the map. */
+struct HashMap
+{
+    int length;   /**< How many keys are currently in the map? */
+    int reserve;  /**< How many slots are allocated, always a power of two */
+    const char** keys; /**< The keys of the slots, NULL for an empty slot */
+    void** values;     /**< The values associated with the keys */
+};
+
+/**
+ * Creates a new struct HashMap and returns a pointer to it
+ *
+ * @param initialCapacity count of keys the map can hold without growing
+ * @return Returns NULL if the memory could not be allocated
+ */
+struct HashMap* hashmap_create(int initialCapacity);
+
+/**
+ * Returns the value associated with key, or NULL if the key is not in the map
+ */
+void* hashmap_get(struct HashMap* map, const char* key);
+
+/**
+ * Associates value with key, replacing the previous value if the key is in the map already
+ *
+ * @return Returns 0 on success, a value greater than that on error
+ */
+int hashmap_put(struct HashMap* map, const char* key, void* value);
+
+/**
+ * Makes sure a struct HashMap can hold at least capacity keys without further allocations
+ *
+ * @return Returns 0 on success, a value greater than that on error
+ */
+int hashmap_reserve(struct HashMap* map, int capacity);
+
+/**
+ * Destroys a given map, but neither its keys nor its values
+ */
+void hashmap_destroy(struct HashMap* map);
+
+#endif /* HASH_MAP_H_ */
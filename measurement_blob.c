@@ -6,12 +6,149 @@
  */
 
 #include "measurement_blob.h"
+#include "spill_file.h"
+#include "arena.h"
+
+/* required for offsetof */
+#include <stddef.h>
+
+/** bytes the arrays of all containers may occupy, 0 if there is no limit */
+static uint64_t memory_budget = 0;
+/** count of values a full array has to hold at least before it is spilled */
+static uint64_t spill_min_chunk = 0;
+/** bytes allocated for the arrays of all containers */
+static uint64_t memory_in_use = 0;
+/** what a full container does once the budget is reached */
+static Blob_Budget_Policy budget_policy = BLOB_BUDGET_SPILL;
+/** count of containers sharing the budget */
+static uint64_t container_count = 0;
+/** highest decimation of any container */
+static uint64_t highest_decimation = 1;
+
+/** count of data points a decimation reduces to their least and greatest one */
+#define BLOBARRAY_DECIMATION_BUCKET 4
 
 /**
  * Utility function to allocate another few bytes of memory
  */
 static int blobarray_allocate_for_more(struct blob_holder* container);
 
+/**
+ * Stores a data point at the end of the array of a container
+ */
+static int blobarray_store(struct blob_holder* container, struct measurement_blob blob);
+
+/**
+ * Appends all values of a full container but the latest one to the scratch file, the latest one is
+ * kept to detect repetitions
+ */
+static int blobarray_spill(struct blob_holder* container);
+
+/**
+ * Halves the data points of a full container in place, keeping the least and the greatest of
+ * every BLOBARRAY_DECIMATION_BUCKET as well as the latest one, and doubles its decimation
+ */
+static int blobarray_decimate(struct blob_holder* container);
+
+/**
+ * Stores the least and the greatest value collected by a decimated container, in the order they
+ * were taken, and, if keep_latest is set, the latest value as well
+ */
+static int blobarray_flush_bucket(struct blob_holder* container, int keep_latest);
+
+/**
+ * Accounts for reserved_delta elements being allocated (or released if negative) for an array
+ */
+static int blobarray_store(struct blob_holder* container, struct measurement_blob blob)
+{
+    /* make sure there is space for at least one more entry, the check is repeated here so that
+     * the common case needs no call */
+    if ((container->length + 1) >= container->reserved && blobarray_allocate_for_more(container))
+    {
+        return 1;
+    }
+    container->arr[container->length] = blob;
+    container->length++;
+    return 0;
+}
+
+static int blobarray_decimate(struct blob_holder* container)
+{
+    if (BLOBARRAY_DECIMATION_BUCKET >= container->length)
+    {
+        return 1;
+    }
+    /* the latest data point is the current value, so it is kept as is */
+    uint64_t end = container->length - 1;
+    uint64_t kept = 0;
+    uint64_t i = 0;
+    for (; i + BLOBARRAY_DECIMATION_BUCKET <= end; i += BLOBARRAY_DECIMATION_BUCKET)
+    {
+        uint64_t min_index = i;
+        uint64_t max_index = i;
+        for (uint64_t j = i + 1; j < i + BLOBARRAY_DECIMATION_BUCKET; ++j)
+        {
+            double value = valueAsDouble(container->arr[j].value, container->datatype);
+            if (value < valueAsDouble(container->arr[min_index].value, container->datatype))
+            {
+                min_index = j;
+            }
+            if (value > valueAsDouble(container->arr[max_index].value, container->datatype))
+            {
+                max_index = j;
+            }
+        }
+        /* kept never passes i, so the data points are moved to the front in place */
+        container->arr[kept++] = container->arr[(min_index < max_index) ? min_index : max_index];
+        if (min_index != max_index)
+        {
+            container->arr[kept++] =
+                container->arr[(min_index < max_index) ? max_index : min_index];
+        }
+    }
+    for (; i <= end; ++i)
+    {
+        container->arr[kept++] = container->arr[i];
+    }
+    container->length = kept;
+    container->decimation *= 2;
+    uint64_t highest = blobarray_highest_decimation();
+    while (container->decimation > highest &&
+           !__atomic_compare_exchange_n(&highest_decimation, &highest, container->decimation, 1,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+    {
+    }
+    return 0;
+}
+
+static int blobarray_flush_bucket(struct blob_holder* container, int keep_latest)
+{
+    if (0 == container->bucket_count)
+    {
+        return 0;
+    }
+    struct measurement_blob first = container->bucket_min;
+    struct measurement_blob second = container->bucket_max;
+    if (second.start_time < first.start_time)
+    {
+        first = container->bucket_max;
+        second = container->bucket_min;
+    }
+    container->bucket_count = 0;
+    int result = blobarray_store(container, first);
+    if (first.start_time != second.start_time || first.value != second.value)
+    {
+        result |= blobarray_store(container, second);
+    }
+    if (keep_latest && container->latest.start_time > second.start_time)
+    {
+        result |= blobarray_store(container, container->latest);
+    }
+    return result;
+}
+
+static void blobarray_account(int64_t reserved_delta);
+
 /**
  * If necessary calculate the diff to an initial value
  */
@@ -134,10 +271,92 @@ uint64_t parseValueBinary(char* binValue, int inputBinaryWidth,
     }
 }
 
+/** copies a value of RAW_TYPE out of each element, swaps its bytes if requested and converts it */
+#define PARSE_STRIDED_LOOP(RAW_TYPE, SWAP, CONVERT)                                                \
+    for (int i = 0; i < count; ++i)                                                                \
+    {                                                                                              \
+        RAW_TYPE raw;                                                                              \
+        memcpy(&raw, binValues + i * stride, sizeof(raw));                                         \
+        if (swapBytes)                                                                             \
+        {                                                                                          \
+            raw = SWAP(raw);                                                                       \
+        }                                                                                          \
+        CONVERT;                                                                                   \
+    }
+/** single bytes do not need swapping */
+#define NO_SWAP(raw) (raw)
+
+void parseValuesBinaryStrided(const char* binValues, int count, uint64_t stride,
+                              Fileparser_Binary_Datatype binaryDatatype, int swapBytes,
+                              uint64_t* values)
+{
+    if (NULL == binValues || NULL == values)
+    {
+        return;
+    }
+    /* the switch is hoisted out of the loops, so each loop is simple enough to be vectorized */
+    switch (binaryDatatype)
+    {
+    case FILEPARSER_BINARY_DATATYPE_UNDEFINED: /* fall-through */
+    case FILEPARSER_BINARY_DATATYPE_INT8:
+        PARSE_STRIDED_LOOP(uint8_t, NO_SWAP, values[i] = (uint64_t)(int64_t)(int8_t)raw)
+        break;
+    case FILEPARSER_BINARY_DATATYPE_INT16:
+        PARSE_STRIDED_LOOP(uint16_t, __builtin_bswap16,
+                           values[i] = (uint64_t)(int64_t)(int16_t)raw)
+        break;
+    case FILEPARSER_BINARY_DATATYPE_INT32:
+        PARSE_STRIDED_LOOP(uint32_t, __builtin_bswap32,
+                           values[i] = (uint64_t)(int64_t)(int32_t)raw)
+        break;
+    case FILEPARSER_BINARY_DATATYPE_INT64: /* fall-through */
+    case FILEPARSER_BINARY_DATATYPE_UINT64:
+        PARSE_STRIDED_LOOP(uint64_t, __builtin_bswap64, values[i] = raw)
+        break;
+    case FILEPARSER_BINARY_DATATYPE_UINT8:
+        PARSE_STRIDED_LOOP(uint8_t, NO_SWAP, values[i] = raw)
+        break;
+    case FILEPARSER_BINARY_DATATYPE_UINT16:
+        PARSE_STRIDED_LOOP(uint16_t, __builtin_bswap16, values[i] = raw)
+        break;
+    case FILEPARSER_BINARY_DATATYPE_UINT32:
+        PARSE_STRIDED_LOOP(uint32_t, __builtin_bswap32, values[i] = raw)
+        break;
+    case FILEPARSER_BINARY_DATATYPE_FLOAT:
+        PARSE_STRIDED_LOOP(uint32_t, __builtin_bswap32, float cpyFloat; double cpyDouble;
+                           memcpy(&cpyFloat, &raw, sizeof(cpyFloat)); cpyDouble = cpyFloat;
+                           memcpy(values + i, &cpyDouble, sizeof(cpyDouble)))
+        break;
+    case FILEPARSER_BINARY_DATATYPE_DOUBLE:
+        PARSE_STRIDED_LOOP(uint64_t, __builtin_bswap64, values[i] = raw)
+        break;
+    }
+}
+
+double valueAsDouble(uint64_t value, SCOREP_MetricValueType curDatatype)
+{
+    union {
+        double dbl;
+        uint64_t uint;
+        int64_t sint;
+    } u_value;
+    u_value.uint = value;
+    switch (curDatatype)
+    {
+    case SCOREP_METRIC_VALUE_UINT64:
+        return (double)u_value.uint;
+    case SCOREP_METRIC_VALUE_DOUBLE:
+        return u_value.dbl;
+    case SCOREP_METRIC_VALUE_INT64: /* fall-through */
+    default:
+        return (double)u_value.sint;
+    }
+}
+
 struct blob_holder* blobarray_create(uint64_t initial_capacity, uint64_t initial_value)
 {
     /* try a calloc */
-    struct blob_holder* container = calloc(1, sizeof(struct blob_holder));
+    struct blob_holder* container = arena_calloc(1, sizeof(struct blob_holder));
     if (NULL != container)
     {
         container->initial_value = initial_value;
@@ -155,6 +374,9 @@ struct blob_holder* blobarray_create(uint64_t initial_capacity, uint64_t initial
         {
             container->reserved = initial_capacity;
         }
+        container->decimation = 1;
+        blobarray_account(container->reserved);
+        __atomic_add_fetch(&container_count, 1, __ATOMIC_RELAXED);
     }
     return container;
 }
@@ -163,50 +385,69 @@ void blobarray_destroy_subelements(struct blob_holder* container)
 {
     if (NULL != container)
     {
+        blobarray_account(-(int64_t)container->reserved);
+        __atomic_sub_fetch(&container_count, 1, __ATOMIC_RELAXED);
         container->length = 0;
         container->reserved = 0;
         container->total_count_stored_values = 0;
+        container->change_count = 0;
+        container->bucket_count = 0;
         free(container->arr);
+        free(container->spilled.chunks);
+        container->spilled.chunks = NULL;
+        container->spilled.count = 0;
+        container->spilled.reserved = 0;
     }
 }
 
 int blobarray_append(struct blob_holder* container, uint64_t value, uint64_t timestamp, int logDif,
                      SCOREP_MetricValueType curDatatype)
 {
-    struct measurement_blob* latest_blob = NULL;
-    int isARepetition = 0;
     /* subtract initial_value from the provided value if necessary */
-    uint64_t to_be_entered_value =
-        figure_out_actual_value(value, container->initial_value, logDif, curDatatype);
+    struct measurement_blob blob = {
+        timestamp, figure_out_actual_value(value, container->initial_value, logDif, curDatatype)
+    };
+    container->datatype = curDatatype;
 
-    if (0 < container->length)
+    /* the provided value was already stored in the previous element, just increase repetition
+     * counter */
+    if ((0 < container->length || 0 < container->bucket_count) &&
+        container->latest.value == blob.value)
     {
-        latest_blob = container->arr + (container->length - 1);
+        container->total_count_stored_values++;
+        return 0;
     }
-    if (NULL != latest_blob)
+    if (1 < container->decimation)
     {
-        /* the provided value was already stored in the previous element, just increase repetition
-         * counter */
-        if (latest_blob->value == to_be_entered_value)
+        /* collect the extremes of the values until they are stored at the decimated rate */
+        double blob_value = valueAsDouble(blob.value, curDatatype);
+        if (0 == container->bucket_count ||
+            blob_value < valueAsDouble(container->bucket_min.value, curDatatype))
         {
-            container->total_count_stored_values++;
-            isARepetition = 1;
+            container->bucket_min = blob;
         }
-    }
-    if (0 == isARepetition)
-    {
-        /* make sure there is space for at least one more entry */
-        if (blobarray_allocate_for_more(container))
+        if (0 == container->bucket_count ||
+            blob_value > valueAsDouble(container->bucket_max.value, curDatatype))
         {
-            return 1;
+            container->bucket_max = blob;
         }
-
-        /* set a new entry in the logging array */
-        container->arr[container->length].start_time = timestamp;
-        container->arr[container->length].value = to_be_entered_value;
+        container->bucket_count++;
+        container->latest = blob;
         container->total_count_stored_values++;
-        container->length++;
+        container->change_count++;
+        if (container->bucket_count >= 2 * container->decimation)
+        {
+            return blobarray_flush_bucket(container, 0);
+        }
+        return 0;
     }
+    if (blobarray_store(container, blob))
+    {
+        return 1;
+    }
+    container->latest = blob;
+    container->total_count_stored_values++;
+    container->change_count++;
     return 0;
 }
 
@@ -257,6 +498,8 @@ int blobarray_get_TimeValuePairs(struct blob_holder* container,
     {
         return -1;
     }
+    /* the extremes collected by a decimated container are part of the data points */
+    blobarray_flush_bucket(container, 1);
     /* allocate memory for providing the values to Score-P */
     int to_be_allocated_count = container->length;
     SCOREP_MetricTimeValuePair* allocated_pairs =
@@ -279,10 +522,141 @@ int blobarray_get_TimeValuePairs(struct blob_holder* container,
     }
 }
 
+/* a measurement_blob array is handed to Score-P as is, so both layouts have to match */
+_Static_assert(sizeof(struct measurement_blob) == sizeof(SCOREP_MetricTimeValuePair) &&
+                   offsetof(struct measurement_blob, start_time) ==
+                       offsetof(SCOREP_MetricTimeValuePair, timestamp) &&
+                   offsetof(struct measurement_blob, value) ==
+                       offsetof(SCOREP_MetricTimeValuePair, value),
+               "measurement_blob does not match SCOREP_MetricTimeValuePair");
+
+int blobarray_swap_TimeValuePairs(struct blob_holder* container, struct measurement_blob* spare,
+                                  uint64_t spare_reserved,
+                                  SCOREP_MetricTimeValuePair** return_reference)
+{
+    if (NULL == container || NULL == spare)
+    {
+        return -1;
+    }
+    /* the extremes collected by a decimated container are part of the data points */
+    blobarray_flush_bucket(container, 1);
+    int swapped_count = container->length;
+    return_reference[0] = (SCOREP_MetricTimeValuePair*)container->arr;
+    /* the array handed over is released by Score-P */
+    blobarray_account((int64_t)spare_reserved - (int64_t)container->reserved);
+    container->arr = spare;
+    container->reserved = spare_reserved;
+    container->length = 0;
+    container->total_count_stored_values = 0;
+    return swapped_count;
+}
+
+void blobarray_set_memory_budget(uint64_t budget, uint64_t min_chunk)
+{
+    memory_budget = budget;
+    spill_min_chunk = min_chunk;
+}
+
+void blobarray_set_budget_policy(Blob_Budget_Policy policy)
+{
+    budget_policy = policy;
+}
+
+uint64_t blobarray_highest_decimation(void)
+{
+    return __atomic_load_n(&highest_decimation, __ATOMIC_RELAXED);
+}
+
+uint64_t blobarray_budget_share(void)
+{
+    uint64_t containers = __atomic_load_n(&container_count, __ATOMIC_RELAXED);
+    if (0 == memory_budget || 0 == containers)
+    {
+        return UINT64_MAX;
+    }
+    return memory_budget / sizeof(struct measurement_blob) / containers;
+}
+
+uint64_t blobarray_memory_in_use(void)
+{
+    return __atomic_load_n(&memory_in_use, __ATOMIC_RELAXED);
+}
+
+void blobarray_take_spilled(struct blob_holder* container, struct blob_spill* spilled)
+{
+    *spilled = container->spilled;
+    container->spilled.chunks = NULL;
+    container->spilled.count = 0;
+    container->spilled.reserved = 0;
+}
+
+int blobarray_prepend_spilled(struct blob_spill* spilled,
+                              SCOREP_MetricTimeValuePair** return_reference, int count)
+{
+    if (0 == spilled->count)
+    {
+        free(spilled->chunks);
+        spilled->chunks = NULL;
+        return count;
+    }
+    uint64_t total_count = count;
+    for (uint64_t i = 0; i < spilled->count; ++i)
+    {
+        total_count += spilled->chunks[i].count;
+    }
+    SCOREP_MetricTimeValuePair* allocated_pairs =
+        malloc(sizeof(SCOREP_MetricTimeValuePair) * total_count);
+    int result = (NULL != allocated_pairs) ? (int)total_count : -1;
+    /* stream the chunks back in the order they were spilled */
+    uint64_t total_index = 0;
+    for (uint64_t i = 0; i < spilled->count; ++i)
+    {
+        size_t chunk_length = spilled->chunks[i].count * sizeof(struct measurement_blob);
+        if (0 <= result)
+        {
+            void* mapping = NULL;
+            size_t mapping_length = 0;
+            const void* chunk = spillfile_map(spilled->chunks[i].offset, chunk_length, &mapping,
+                                              &mapping_length);
+            if (NULL == chunk)
+            {
+                result = -1;
+            }
+            else
+            {
+                memcpy(allocated_pairs + total_index, chunk, chunk_length);
+                total_index += spilled->chunks[i].count;
+                spillfile_unmap(mapping, mapping_length);
+            }
+        }
+        spillfile_release(spilled->chunks[i].offset, chunk_length);
+    }
+    free(spilled->chunks);
+    spilled->chunks = NULL;
+    spilled->count = 0;
+    spilled->reserved = 0;
+    if (0 > result)
+    {
+        free(allocated_pairs);
+        free(return_reference[0]);
+        return_reference[0] = NULL;
+        return -1;
+    }
+    if (0 < count)
+    {
+        memcpy(allocated_pairs + total_index, return_reference[0],
+               count * sizeof(SCOREP_MetricTimeValuePair));
+    }
+    free(return_reference[0]);
+    return_reference[0] = allocated_pairs;
+    return result;
+}
+
 void blobarray_reset(struct blob_holder* container)
 {
     container->length = 0;
     container->total_count_stored_values = 0;
+    container->bucket_count = 0;
 }
 
 static int blobarray_allocate_for_more(struct blob_holder* container)
@@ -300,6 +674,24 @@ static int blobarray_allocate_for_more(struct blob_holder* container)
         {
             newReserve = 2;
         }
+        /* rather spill or decimate a large enough array than grow beyond the budget, growing if
+         * that fails. Only arrays holding at least their share of the budget are decimated, so
+         * the ones with the most data points lose resolution first. */
+        uint64_t growth = (newReserve - container->reserved) * sizeof(struct measurement_blob);
+        if (0 < memory_budget && spill_min_chunk <= container->length &&
+            blobarray_memory_in_use() + growth > memory_budget)
+        {
+            uint64_t share = blobarray_budget_share();
+            if (BLOB_BUDGET_SPILL == budget_policy && 0 == blobarray_spill(container))
+            {
+                return 0;
+            }
+            if (BLOB_BUDGET_DECIMATE == budget_policy && share <= container->length &&
+                0 == blobarray_decimate(container))
+            {
+                return 0;
+            }
+        }
         /* try realloc of the container's logging array */
         /* error occured here, when calling this function from blobarray_append:
          * realloc(): invalid next size: 0x0000000002918790 ****/
@@ -307,6 +699,7 @@ static int blobarray_allocate_for_more(struct blob_holder* container)
             realloc(container->arr, newReserve * sizeof(struct measurement_blob));
         if (NULL != reallocSwap)
         {
+            blobarray_account((int64_t)newReserve - (int64_t)container->reserved);
             container->arr = reallocSwap;
             container->reserved = newReserve;
         }
@@ -318,6 +711,7 @@ static int blobarray_allocate_for_more(struct blob_holder* container)
             reallocSwap = realloc(container->arr, newReserve * sizeof(struct measurement_blob));
             if (NULL != reallocSwap)
             {
+                blobarray_account((int64_t)newReserve - (int64_t)container->reserved);
                 container->arr = reallocSwap;
                 container->reserved = newReserve;
             }
@@ -332,3 +726,42 @@ static int blobarray_allocate_for_more(struct blob_holder* container)
     }
     return 0;
 }
+
+static int blobarray_spill(struct blob_holder* container)
+{
+    if (2 > container->length)
+    {
+        return 1;
+    }
+    struct blob_spill* spilled = &container->spilled;
+    if (spilled->count == spilled->reserved)
+    {
+        uint64_t newReserve = (0 < spilled->reserved) ? spilled->reserved * 2 : 4;
+        struct blob_spill_chunk* reallocChunks =
+            realloc(spilled->chunks, newReserve * sizeof(struct blob_spill_chunk));
+        if (NULL == reallocChunks)
+        {
+            return 2;
+        }
+        spilled->chunks = reallocChunks;
+        spilled->reserved = newReserve;
+    }
+    uint64_t spill_count = container->length - 1;
+    uint64_t offset = 0;
+    if (spillfile_append(container->arr, spill_count * sizeof(struct measurement_blob), &offset))
+    {
+        return 3;
+    }
+    spilled->chunks[spilled->count].offset = offset;
+    spilled->chunks[spilled->count].count = spill_count;
+    spilled->count++;
+    container->arr[0] = container->arr[spill_count];
+    container->length = 1;
+    return 0;
+}
+
+static void blobarray_account(int64_t reserved_delta)
+{
+    __atomic_add_fetch(&memory_in_use, reserved_delta * (int64_t)sizeof(struct measurement_blob),
+                       __ATOMIC_RELAXED);
+}
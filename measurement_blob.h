@@ -26,6 +26,21 @@ struct measurement_blob
     uint64_t value;      /**< logged value */
 };
 
+/* A run of measurement_blobs that was spilled to the scratch file */
+struct blob_spill_chunk
+{
+    uint64_t offset; /**< offset of the first measurement_blob within the scratch file */
+    uint64_t count;  /**< count of measurement_blobs */
+};
+
+/* The chunks of a container that were spilled to the scratch file, oldest first */
+struct blob_spill
+{
+    struct blob_spill_chunk* chunks; /**< the spilled chunks */
+    uint64_t count;                  /**< count of used elements in chunks */
+    uint64_t reserved;               /**< how much space is allocated for elements in chunks */
+};
+
 /* A container for holding measurement_blobs */
 struct blob_holder
 {
@@ -33,10 +48,27 @@ struct blob_holder
     uint64_t reserved; /**< how much space is allocated for measurement_blob elements in arr */
     uint64_t total_count_stored_values; /**< count of values that have been stored (including
                                            repetitions) */
+    uint64_t change_count; /**< count of values that have been stored (excluding repetitions) */
     uint64_t initial_value;       /**< the initial value that can be subtracted from each entry */
     struct measurement_blob* arr; /**< the array to hold the logged values */
+    struct blob_spill spilled;    /**< the logged values preceding the ones in arr that were
+                                     spilled to the scratch file */
+    struct measurement_blob latest; /**< the latest value that was no repetition */
+    SCOREP_MetricValueType datatype; /**< how the values are compared when decimating */
+    uint64_t decimation; /**< factor by which the values were decimated to keep the memory budget,
+                            1 if all are kept */
+    uint64_t bucket_count; /**< count of values collected since the extremes were last stored */
+    struct measurement_blob bucket_min; /**< the least value collected since then */
+    struct measurement_blob bucket_max; /**< the greatest value collected since then */
 };
 
+/* What a container does once its array is full and growing it would exceed the memory budget */
+typedef enum Blob_Budget_Policy
+{
+    BLOB_BUDGET_SPILL,   /**< the values are spilled to the scratch file */
+    BLOB_BUDGET_DECIMATE /**< the values are decimated in place, keeping the extremes */
+} Blob_Budget_Policy;
+
 typedef enum Fileparser_Binary_Datatype
 {
     FILEPARSER_BINARY_DATATYPE_UNDEFINED,
@@ -65,9 +97,24 @@ uint64_t parseValue(char* strValue, SCOREP_MetricValueType curDatatype, int isHe
 uint64_t parseValueBinary(char* binValue, int inputBinaryWidth,
                           Fileparser_Binary_Datatype binaryDatatype);
 
+/**
+ * Parses count binary values, which are stride bytes apart, according to binaryDatatype into
+ * values. The bytes of each value are swapped first if swapBytes is set, i.e. if the byte order of
+ * the input differs from the host's.
+ */
+void parseValuesBinaryStrided(const char* binValues, int count, uint64_t stride,
+                              Fileparser_Binary_Datatype binaryDatatype, int swapBytes,
+                              uint64_t* values);
+
+/**
+ * Interprets a value returned by parseValue or parseValueBinary according to curDatatype and
+ * converts it to double
+ */
+double valueAsDouble(uint64_t value, SCOREP_MetricValueType curDatatype);
+
 /**
  * Creates a new container with an initial_capacity and an initial_value (which is heeded later when
- * calculating a dif)
+ * calculating a dif). The container is to be released by arena_free.
  */
 struct blob_holder* blobarray_create(uint64_t initial_capacity, uint64_t initial_value);
 
@@ -83,6 +130,54 @@ void blobarray_destroy_subelements(struct blob_holder* container);
 int blobarray_append(struct blob_holder* container, uint64_t value, uint64_t timestamp, int logDif,
                      SCOREP_MetricValueType curDatatype);
 
+/**
+ * Limits the memory allocated for the arrays of all containers to budget bytes, 0 meaning no
+ * limit. A container whose array is full and holds at least min_chunk values spills them to the
+ * scratch file instead of growing beyond the budget.
+ */
+void blobarray_set_memory_budget(uint64_t budget, uint64_t min_chunk);
+
+/**
+ * Selects what a container does once growing it would exceed the memory budget. With
+ * BLOB_BUDGET_DECIMATE, a container holding at least its share of the budget halves its values in
+ * place, keeping the least and the greatest of every four, and from then on only stores the least
+ * and the greatest of each run of 2 * decimation values.
+ */
+void blobarray_set_budget_policy(Blob_Budget_Policy policy);
+
+/**
+ * Returns the highest factor by which the values of any container were decimated, 1 if all
+ * values were kept
+ */
+uint64_t blobarray_highest_decimation(void);
+
+/**
+ * Returns the count of data points each container may hold within the memory budget, UINT64_MAX if
+ * there is no budget
+ */
+uint64_t blobarray_budget_share(void);
+
+/**
+ * Returns the count of bytes allocated for the arrays of all containers
+ */
+uint64_t blobarray_memory_in_use(void);
+
+/**
+ * Moves the chunks a container spilled to the scratch file into spilled, the container continues
+ * without spilled chunks
+ */
+void blobarray_take_spilled(struct blob_holder* container, struct blob_spill* spilled);
+
+/**
+ * Reads the chunks of spilled back from the scratch file and places them in front of the count
+ * data points of return_reference, which is reallocated. Releases the chunks.
+ *
+ * @return Returns the count of data points in return_reference, -1 if the chunks could not be read
+ * back, in which case return_reference is freed
+ */
+int blobarray_prepend_spilled(struct blob_spill* spilled,
+                              SCOREP_MetricTimeValuePair** return_reference, int count);
+
 /**
  * This function resets a given container to zero, so it can be reused without delay
  */
@@ -94,4 +189,13 @@ void blobarray_reset(struct blob_holder* container);
 int blobarray_get_TimeValuePairs(struct blob_holder* container,
                                  SCOREP_MetricTimeValuePair** return_reference);
 
+/**
+ * Hands the logged data points over without copying them: return_reference is set to the array of
+ * the container, which continues logging into spare, an array of spare_reserved elements. Returns
+ * the count of data points handed over.
+ */
+int blobarray_swap_TimeValuePairs(struct blob_holder* container, struct measurement_blob* spare,
+                                  uint64_t spare_reserved,
+                                  SCOREP_MetricTimeValuePair** return_reference);
+
 #endif /* MEASUREMENT_BLOB_H_ */
@@ -0,0 +1,67 @@
+/*
+ * period_histogram.c
+ *
+ *  Created on: 19.10.2026
+ */
+
+#include "period_histogram.h"
+
+/* required for snprintf */
+#include <stdio.h>
+/* required for calloc */
+#include <stdlib.h>
+
+struct period_histogram* periodhistogram_create(uint64_t target)
+{
+    struct period_histogram* histogram = calloc(1, sizeof(struct period_histogram));
+    if (NULL == histogram)
+    {
+        return NULL;
+    }
+    histogram->target = target;
+    histogram->resolution = target / PERIOD_HISTOGRAM_BUCKETS_PER_PERIOD;
+    if (0 == histogram->resolution)
+    {
+        histogram->resolution = 1;
+    }
+    return histogram;
+}
+
+uint64_t periodhistogram_quantile(const struct period_histogram* histogram, double fraction)
+{
+    if (0 == histogram->count)
+    {
+        return 0;
+    }
+    uint64_t wanted = (uint64_t)(fraction * histogram->count);
+    uint64_t seen = 0;
+    for (int i = 0; i < PERIOD_HISTOGRAM_BUCKETS - 1; ++i)
+    {
+        seen += histogram->buckets[i];
+        if (seen > wanted)
+        {
+            /* the upper bound of the bucket, but never beyond the periods actually seen */
+            uint64_t bound = (i + 1) * histogram->resolution;
+            return (bound < histogram->max) ? bound : histogram->max;
+        }
+    }
+    return histogram->max;
+}
+
+void periodhistogram_describe(const struct period_histogram* histogram, char* buf,
+                              size_t length)
+{
+    if (0 == histogram->count)
+    {
+        snprintf(buf, length, "no periods");
+        return;
+    }
+    snprintf(buf, length,
+             "%llu periods, min %.1f us, mean %.1f us, median %.1f us, 99%% %.1f us, max %.1f us, "
+             "%llu late",
+             (unsigned long long)histogram->count, histogram->min / 1e3,
+             (double)histogram->sum / histogram->count / 1e3,
+             periodhistogram_quantile(histogram, 0.5) / 1e3,
+             periodhistogram_quantile(histogram, 0.99) / 1e3, histogram->max / 1e3,
+             (unsigned long long)histogram->late);
+}
@@ -0,0 +1,69 @@
+/*
+ * period_histogram.h
+ *
+ *  Created on: 19.10.2026
+ */
+
+#ifndef PERIOD_HISTOGRAM_H_
+#define PERIOD_HISTOGRAM_H_
+
+/* required for size_t */
+#include <stddef.h>
+/* required for uint64_t */
+#include <stdint.h>
+
+/** count of buckets of a histogram, the last one collects all periods beyond the others */
+#define PERIOD_HISTOGRAM_BUCKETS 1024
+/** count of buckets covering the target period */
+#define PERIOD_HISTOGRAM_BUCKETS_PER_PERIOD 16
+
+/* The distribution of the periods achieved by a periodic activity */
+struct period_histogram
+{
+    uint64_t target;     /**< the intended period in ns */
+    uint64_t resolution; /**< width of a bucket in ns */
+    uint64_t count;      /**< count of periods added */
+    uint64_t sum;        /**< sum of all periods added in ns */
+    uint64_t min;        /**< shortest period added in ns */
+    uint64_t max;        /**< longest period added in ns */
+    uint64_t late;       /**< count of periods longer than twice the target */
+    uint64_t buckets[PERIOD_HISTOGRAM_BUCKETS]; /**< count of periods per bucket */
+};
+
+/**
+ * Creates an empty histogram for periods around target ns, resolving a period in
+ * PERIOD_HISTOGRAM_BUCKETS_PER_PERIOD steps
+ *
+ * @return Returns the histogram to be freed with free, NULL if memory ran out
+ */
+struct period_histogram* periodhistogram_create(uint64_t target);
+
+/**
+ * Adds an achieved period in ns, a few instructions without any allocation
+ */
+static inline void periodhistogram_add(struct period_histogram* histogram, uint64_t period)
+{
+    uint64_t bucket = period / histogram->resolution;
+    histogram->buckets[(bucket < PERIOD_HISTOGRAM_BUCKETS) ? bucket
+                                                           : PERIOD_HISTOGRAM_BUCKETS - 1]++;
+    histogram->min = (0 == histogram->count || period < histogram->min) ? period : histogram->min;
+    histogram->max = (period > histogram->max) ? period : histogram->max;
+    histogram->late += (period > 2 * histogram->target);
+    histogram->sum += period;
+    histogram->count++;
+}
+
+/**
+ * Returns the period in ns below which the given fraction of the periods lie, to the resolution of
+ * the buckets
+ */
+uint64_t periodhistogram_quantile(const struct period_histogram* histogram, double fraction);
+
+/**
+ * Writes a human readable summary of the distribution, e.g. "1000 periods, min 9.8 us, mean 10.0
+ * us, median 10.0 us, 99% 10.6 us, max 61.2 us, 2 late", to buf
+ */
+void periodhistogram_describe(const struct period_histogram* histogram, char* buf,
+                              size_t length);
+
+#endif /* PERIOD_HISTOGRAM_H_ */
@@ -0,0 +1,148 @@
+/*
+ * sample_log.c
+ *
+ *  Created on: 19.10.2026
+ */
+
+#include "sample_log.h"
+
+/* required for open, posix_fallocate */
+#include <fcntl.h>
+/* required for calloc, free */
+#include <stdlib.h>
+/* required for memcpy, strncpy */
+#include <string.h>
+/* required for mmap, msync, munmap */
+#include <sys/mman.h>
+/* required for ftruncate, close, sysconf */
+#include <unistd.h>
+
+/** count of bytes of records that are written back at once */
+#define SAMPLE_LOG_SYNC_BYTES (1 << 20)
+
+static void syncRecords(struct sample_log* log, uint64_t firstRecord, uint64_t endRecord,
+                        int flags);
+
+struct sample_log* samplelog_open(const char* path, uint64_t size, uint32_t metricCapacity)
+{
+    uint64_t metricTableOffset = sizeof(struct sample_log_header);
+    uint64_t recordOffset = metricTableOffset + metricCapacity * sizeof(struct sample_log_metric);
+    if (size < recordOffset + sizeof(struct sample_log_record))
+    {
+        return NULL;
+    }
+    struct sample_log* log = calloc(1, sizeof(struct sample_log));
+    if (NULL == log)
+    {
+        return NULL;
+    }
+    log->fd = open(path, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (-1 == log->fd)
+    {
+        free(log);
+        return NULL;
+    }
+    /* allocate all blocks now, so that a full file system cannot fault a store into the mapping */
+    if (posix_fallocate(log->fd, 0, size))
+    {
+        close(log->fd);
+        unlink(path);
+        free(log);
+        return NULL;
+    }
+    log->mappingLength = size;
+    log->mapping = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, log->fd, 0);
+    if (MAP_FAILED == log->mapping)
+    {
+        close(log->fd);
+        unlink(path);
+        free(log);
+        return NULL;
+    }
+    log->header = (struct sample_log_header*)log->mapping;
+    log->metrics = (struct sample_log_metric*)(log->mapping + metricTableOffset);
+    log->records = (struct sample_log_record*)(log->mapping + recordOffset);
+    log->recordCapacity = (size - recordOffset) / sizeof(struct sample_log_record);
+
+    memcpy(log->header->magic, SAMPLE_LOG_MAGIC, sizeof(log->header->magic));
+    log->header->version = SAMPLE_LOG_VERSION;
+    log->header->headerSize = sizeof(struct sample_log_header);
+    log->header->metricSize = sizeof(struct sample_log_metric);
+    log->header->recordSize = sizeof(struct sample_log_record);
+    log->header->metricTableOffset = metricTableOffset;
+    log->header->metricCapacity = metricCapacity;
+    log->header->recordOffset = recordOffset;
+    log->header->recordCapacity = log->recordCapacity;
+    msync(log->mapping, recordOffset, MS_ASYNC);
+    return log;
+}
+
+int samplelog_add_metric(struct sample_log* log, uint32_t index, const char* name,
+                         const char* unit, uint32_t datatype)
+{
+    if (index >= log->header->metricCapacity)
+    {
+        return 1;
+    }
+    struct sample_log_metric* metric = log->metrics + index;
+    metric->datatype = datatype;
+    strncpy(metric->name, (NULL != name) ? name : "", SAMPLE_LOG_NAME_LENGTH - 1);
+    strncpy(metric->unit, (NULL != unit) ? unit : "", SAMPLE_LOG_UNIT_LENGTH - 1);
+    __atomic_store_n(&metric->used, 1, __ATOMIC_RELEASE);
+    return 0;
+}
+
+void samplelog_commit(struct sample_log* log)
+{
+    uint64_t recordCount = __atomic_load_n(&log->recordCount, __ATOMIC_RELAXED);
+    log->header->recordCount = recordCount;
+    if ((recordCount - log->syncedCount) * sizeof(struct sample_log_record) >=
+        SAMPLE_LOG_SYNC_BYTES)
+    {
+        syncRecords(log, log->syncedCount, recordCount, MS_ASYNC);
+        msync(log->mapping, log->header->recordOffset, MS_ASYNC);
+        log->syncedCount = recordCount;
+    }
+}
+
+void samplelog_set_clock(struct sample_log* log, double ticksPerSecond, uint64_t anchorTicks,
+                         uint64_t anchorRealtime)
+{
+    log->header->ticksPerSecond = ticksPerSecond;
+    log->header->anchorTicks = anchorTicks;
+    log->header->anchorRealtime = anchorRealtime;
+}
+
+void samplelog_close(struct sample_log* log)
+{
+    if (NULL == log)
+    {
+        return;
+    }
+    log->header->recordCount = log->recordCount;
+    /* the records that were never written are of no use */
+    uint64_t usedLength =
+        log->header->recordOffset + log->recordCount * sizeof(struct sample_log_record);
+    msync(log->mapping, log->mappingLength, MS_SYNC);
+    munmap(log->mapping, log->mappingLength);
+    if (ftruncate(log->fd, usedLength))
+    {
+        /* the file keeps its zero-filled tail, which readers skip */
+    }
+    close(log->fd);
+    free(log);
+}
+
+/**
+ * Writes back the pages holding the records from firstRecord up to endRecord
+ */
+static void syncRecords(struct sample_log* log, uint64_t firstRecord, uint64_t endRecord,
+                        int flags)
+{
+    uint64_t pageSize = sysconf(_SC_PAGESIZE);
+    uint64_t begin =
+        log->header->recordOffset + firstRecord * sizeof(struct sample_log_record);
+    uint64_t end = log->header->recordOffset + endRecord * sizeof(struct sample_log_record);
+    begin -= begin % pageSize;
+    msync(log->mapping + begin, end - begin, flags);
+}
@@ -0,0 +1,147 @@
+/*
+ * sample_log.h
+ *
+ *  Created on: 19.10.2026
+ */
+
+#ifndef SAMPLE_LOG_H_
+#define SAMPLE_LOG_H_
+
+/* required for uint64_t, uint32_t */
+#include <stdint.h>
+/* required for size_t */
+#include <stddef.h>
+
+/*
+ * Format of the sample log, a file written through a shared mapping while the plugin samples, so
+ * that the samples survive a process that never reaches its finalization:
+ *
+ *   struct sample_log_header
+ *   struct sample_log_metric[metricCapacity]   at metricTableOffset
+ *   struct sample_log_record[recordCapacity]   at recordOffset
+ *
+ * All integers are in the byte order of the host that wrote the log. The file is preallocated and
+ * zero-filled, so a record whose metric is 0 was never written. recordCount is only updated once
+ * per sampling cycle, a reader takes the records following it as long as their metric is set.
+ */
+
+/** identifies a sample log */
+#define SAMPLE_LOG_MAGIC "FPSMPLOG"
+/** version of the format described here */
+#define SAMPLE_LOG_VERSION 1
+/** count of bytes reserved for the name of a metric, including the terminating null byte */
+#define SAMPLE_LOG_NAME_LENGTH 192
+/** count of bytes reserved for the unit of a metric, including the terminating null byte */
+#define SAMPLE_LOG_UNIT_LENGTH 56
+
+/* The header at the beginning of the log */
+struct sample_log_header
+{
+    char magic[8];              /**< SAMPLE_LOG_MAGIC, without terminating null byte */
+    uint32_t version;           /**< SAMPLE_LOG_VERSION */
+    uint32_t headerSize;        /**< sizeof(struct sample_log_header) */
+    uint32_t metricSize;        /**< sizeof(struct sample_log_metric) */
+    uint32_t recordSize;        /**< sizeof(struct sample_log_record) */
+    uint64_t metricTableOffset; /**< offset of the metric table within the file */
+    uint64_t metricCapacity;    /**< count of entries of the metric table */
+    uint64_t recordOffset;      /**< offset of the first record within the file */
+    uint64_t recordCapacity;    /**< count of records that fit into the file */
+    uint64_t recordCount;       /**< count of records written until the latest sampling cycle */
+    uint64_t droppedRecords;    /**< count of records that did not fit into the file */
+    double ticksPerSecond;      /**< rate of the clock of the timestamps, 0 if not known yet */
+    uint64_t anchorTicks;       /**< a timestamp known to correspond to anchorRealtime */
+    uint64_t anchorRealtime;    /**< CLOCK_REALTIME in ns at anchorTicks */
+};
+
+/* An entry of the metric table, its index plus one identifies the metric in records */
+struct sample_log_metric
+{
+    uint32_t used;                      /**< 1 if the entry describes a metric, 0 otherwise */
+    uint32_t datatype;                  /**< SCOREP_MetricValueType of the values */
+    char name[SAMPLE_LOG_NAME_LENGTH];  /**< name of the metric, truncated if too long */
+    char unit[SAMPLE_LOG_UNIT_LENGTH];  /**< unit of the metric, truncated if too long */
+};
+
+/* A single sample, as handed to Score-P */
+struct sample_log_record
+{
+    uint64_t timestamp; /**< time of the sample in ticks of the Score-P clock */
+    uint64_t value;     /**< value of the sample, interpreted according to the metric's datatype */
+    uint32_t metric;    /**< index of the metric in the metric table plus one */
+    uint32_t reserved;  /**< padding, 0 */
+};
+
+/* The state of a log being written */
+struct sample_log
+{
+    int fd;                             /**< descriptor of the log file */
+    char* mapping;                      /**< the whole file, mapped shared */
+    size_t mappingLength;               /**< length of mapping, i.e. of the file */
+    struct sample_log_header* header;   /**< the header at the beginning of mapping */
+    struct sample_log_metric* metrics;  /**< the metric table within mapping */
+    struct sample_log_record* records;  /**< the records within mapping */
+    uint64_t recordCount;               /**< count of records written */
+    uint64_t recordCapacity;            /**< count of records that fit into the file */
+    uint64_t syncedCount;               /**< count of records handed to msync already */
+};
+
+/**
+ * Creates a log file of size bytes at path, which is preallocated, mapped and given a header and an
+ * empty metric table of metricCapacity entries
+ *
+ * @return Returns the log, NULL if the file could not be created, allocated or mapped
+ */
+struct sample_log* samplelog_open(const char* path, uint64_t size, uint32_t metricCapacity);
+
+/**
+ * Describes the metric with the given index in the metric table
+ *
+ * @return Returns 0 on success, a value greater than that if index exceeds the metric table
+ */
+int samplelog_add_metric(struct sample_log* log, uint32_t index, const char* name,
+                         const char* unit, uint32_t datatype);
+
+/**
+ * Appends a sample of the metric with the given index, a few stores into the mapping, safe to be
+ * called by several threads. Samples that do not fit into the file any more are counted as dropped.
+ */
+static inline void samplelog_append(struct sample_log* log, uint32_t index, uint64_t timestamp,
+                                    uint64_t value)
+{
+    /* records are claimed atomically, as the high-frequency sampling thread appends as well */
+    uint64_t recordIndex = __atomic_load_n(&log->recordCount, __ATOMIC_RELAXED);
+    do
+    {
+        if (recordIndex >= log->recordCapacity)
+        {
+            __atomic_fetch_add(&log->header->droppedRecords, 1, __ATOMIC_RELAXED);
+            return;
+        }
+    } while (!__atomic_compare_exchange_n(&log->recordCount, &recordIndex, recordIndex + 1, 1,
+                                          __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+    struct sample_log_record* record = log->records + recordIndex;
+    record->timestamp = timestamp;
+    record->value = value;
+    /* set last, as it marks the record as written */
+    __atomic_store_n(&record->metric, index + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * Publishes the count of records in the header and starts writing back the records appended since
+ * the previous write back, once they fill at least a batch
+ */
+void samplelog_commit(struct sample_log* log);
+
+/**
+ * Stores the rate of the clock of the timestamps and a timestamp corresponding to a CLOCK_REALTIME
+ * time in ns, so that readers can convert timestamps to times of day
+ */
+void samplelog_set_clock(struct sample_log* log, double ticksPerSecond, uint64_t anchorTicks,
+                         uint64_t anchorRealtime);
+
+/**
+ * Writes back all records, truncates the file behind the last record and releases the log
+ */
+void samplelog_close(struct sample_log* log);
+
+#endif /* SAMPLE_LOG_H_ */
@@ -0,0 +1,373 @@
+/*
+ * sampler_placement.c
+ *
+ *  Created on: 19.10.2026
+ */
+
+/* required for cpu_set_t, pthread_attr_setaffinity_np */
+#define _GNU_SOURCE
+
+#include "sampler_placement.h"
+
+/* required for errno */
+#include <errno.h>
+/* required for bool */
+#include <stdbool.h>
+/* required for fopen, snprintf */
+#include <stdio.h>
+/* required for getenv, strtol */
+#include <stdlib.h>
+/* required for strcmp, strncmp, strlen */
+#include <string.h>
+/* required for cpu_set_t, SCHED_IDLE, SCHED_BATCH, SCHED_FIFO */
+#include <sched.h>
+/* required for setpriority */
+#include <sys/resource.h>
+/* required for SYS_gettid */
+#include <sys/syscall.h>
+/* required for syscall */
+#include <unistd.h>
+
+/** longest CPU list read from sysfs */
+#define CPULIST_MAX_LENGTH 4096
+
+static bool hasCpus = false;
+static bool cpusAreDefault = false;
+static cpu_set_t cpus;
+static int policy = SCHED_OTHER;
+static int priority = 0;
+static bool hasNice = false;
+static int niceValue = 0;
+/** CPU the high-frequency sampling thread is pinned to, -1 if it is placed like the sampler */
+static int highFrequencyCpu = -1;
+
+/**
+ * Parses a CPU list like "0-3,8,10-11" into set
+ *
+ * @return Returns 0 on success, a value greater than that if the list is malformed
+ */
+static int parseCpuList(const char* cpuList, cpu_set_t* set)
+{
+    CPU_ZERO(set);
+    const char* curPos = cpuList;
+    while ('\0' != *curPos && '\n' != *curPos)
+    {
+        char* endPtr = NULL;
+        long first = strtol(curPos, &endPtr, 10);
+        long last = first;
+        if (endPtr == curPos || 0 > first)
+        {
+            return 1;
+        }
+        if ('-' == *endPtr)
+        {
+            curPos = endPtr + 1;
+            last = strtol(curPos, &endPtr, 10);
+            if (endPtr == curPos || last < first)
+            {
+                return 1;
+            }
+        }
+        if (CPU_SETSIZE <= last)
+        {
+            return 2;
+        }
+        if (',' != *endPtr && '\0' != *endPtr && '\n' != *endPtr)
+        {
+            return 1;
+        }
+        for (long cpu = first; cpu <= last; ++cpu)
+        {
+            CPU_SET(cpu, set);
+        }
+        curPos = (',' == *endPtr) ? endPtr + 1 : endPtr;
+    }
+    return 0;
+}
+
+/**
+ * Reads a CPU list from a file in sysfs, a missing or empty file yields an empty set
+ *
+ * @return Returns 0 on success, a value greater than that if the file could not be parsed
+ */
+static int readCpuListFile(const char* path, cpu_set_t* set)
+{
+    char cpuList[CPULIST_MAX_LENGTH] = "";
+    CPU_ZERO(set);
+    FILE* file = fopen(path, "r");
+    if (NULL == file)
+    {
+        return 0;
+    }
+    bool couldRead = (NULL != fgets(cpuList, sizeof(cpuList), file));
+    fclose(file);
+    return couldRead ? parseCpuList(cpuList, set) : 0;
+}
+
+/**
+ * Derives the default CPUs of the sampler: the online CPUs which are neither isolated nor
+ * nohz_full. If no CPU is isolated, the sampler keeps the affinity it inherits.
+ */
+static void setDefaultCpus(void)
+{
+    cpu_set_t online, isolated, nohzFull, reserved;
+    if (readCpuListFile("/sys/devices/system/cpu/online", &online) ||
+        readCpuListFile("/sys/devices/system/cpu/isolated", &isolated) ||
+        readCpuListFile("/sys/devices/system/cpu/nohz_full", &nohzFull))
+    {
+        return;
+    }
+    CPU_OR(&reserved, &isolated, &nohzFull);
+    if (0 == CPU_COUNT(&reserved))
+    {
+        return;
+    }
+    CPU_XOR(&cpus, &online, &reserved);
+    CPU_AND(&cpus, &cpus, &online);
+    if (0 < CPU_COUNT(&cpus))
+    {
+        hasCpus = true;
+        cpusAreDefault = true;
+    }
+}
+
+int samplerplacement_read_env(void)
+{
+    int result = 0;
+    hasCpus = false;
+    cpusAreDefault = false;
+    const char* fromEnv = getenv("SCOREP_METRIC_FILEPARSER_PLUGIN_CPUS");
+    if (NULL == fromEnv)
+    {
+        setDefaultCpus();
+    }
+    else if (0 != strcmp(fromEnv, "inherit"))
+    {
+        if (0 == parseCpuList(fromEnv, &cpus) && 0 < CPU_COUNT(&cpus))
+        {
+            hasCpus = true;
+        }
+        else
+        {
+            result = 1;
+        }
+    }
+
+    policy = SCHED_OTHER;
+    priority = 0;
+    fromEnv = getenv("SCOREP_METRIC_FILEPARSER_PLUGIN_SCHED");
+    if (NULL != fromEnv)
+    {
+        const char* posOfColon = strchr(fromEnv, ':');
+        size_t nameLength =
+            (NULL != posOfColon) ? (size_t)(posOfColon - fromEnv) : strlen(fromEnv);
+        if (5 == nameLength && 0 == strncmp(fromEnv, "other", nameLength))
+        {
+            policy = SCHED_OTHER;
+        }
+        else if (4 == nameLength && 0 == strncmp(fromEnv, "idle", nameLength))
+        {
+            policy = SCHED_IDLE;
+        }
+        else if (5 == nameLength && 0 == strncmp(fromEnv, "batch", nameLength))
+        {
+            policy = SCHED_BATCH;
+        }
+        else if (4 == nameLength && 0 == strncmp(fromEnv, "fifo", nameLength))
+        {
+            policy = SCHED_FIFO;
+        }
+        else if (2 == nameLength && 0 == strncmp(fromEnv, "rr", nameLength))
+        {
+            policy = SCHED_RR;
+        }
+        else
+        {
+            result = 2;
+        }
+        if (SCHED_FIFO == policy || SCHED_RR == policy)
+        {
+            /* real-time priorities default to the lowest one */
+            priority = sched_get_priority_min(policy);
+            if (NULL != posOfColon)
+            {
+                int givenPriority = atoi(posOfColon + 1);
+                if (sched_get_priority_min(policy) <= givenPriority &&
+                    givenPriority <= sched_get_priority_max(policy))
+                {
+                    priority = givenPriority;
+                }
+                else
+                {
+                    result = 3;
+                }
+            }
+        }
+    }
+
+    hasNice = false;
+    fromEnv = getenv("SCOREP_METRIC_FILEPARSER_PLUGIN_NICE");
+    if (NULL != fromEnv)
+    {
+        char* endPtr = NULL;
+        long givenNice = strtol(fromEnv, &endPtr, 10);
+        if (endPtr != fromEnv && -20 <= givenNice && givenNice <= 19)
+        {
+            hasNice = true;
+            niceValue = givenNice;
+        }
+        else
+        {
+            result = 4;
+        }
+    }
+
+    highFrequencyCpu = -1;
+    fromEnv = getenv("SCOREP_METRIC_FILEPARSER_PLUGIN_HF_CPU");
+    if (NULL != fromEnv)
+    {
+        char* endPtr = NULL;
+        long givenCpu = strtol(fromEnv, &endPtr, 10);
+        if (endPtr != fromEnv && '\0' == *endPtr && 0 <= givenCpu && givenCpu < CPU_SETSIZE)
+        {
+            highFrequencyCpu = givenCpu;
+        }
+        else
+        {
+            result = 5;
+        }
+    }
+    return result;
+}
+
+void samplerplacement_describe(char* buf, size_t length)
+{
+    size_t used = 0;
+    if (hasCpus)
+    {
+        const char* separator = "CPUs ";
+        for (int cpu = 0; cpu < CPU_SETSIZE && used < length; ++cpu)
+        {
+            if (!CPU_ISSET(cpu, &cpus) || (0 < cpu && CPU_ISSET(cpu - 1, &cpus)))
+            {
+                continue;
+            }
+            int last = cpu;
+            while (last + 1 < CPU_SETSIZE && CPU_ISSET(last + 1, &cpus))
+            {
+                ++last;
+            }
+            if (last == cpu)
+            {
+                used += snprintf(buf + used, length - used, "%s%d", separator, cpu);
+            }
+            else
+            {
+                used += snprintf(buf + used, length - used, "%s%d-%d", separator, cpu, last);
+            }
+            separator = ",";
+        }
+        if (cpusAreDefault && used < length)
+        {
+            used += snprintf(buf + used, length - used, " (not isolated)");
+        }
+    }
+    else
+    {
+        used += snprintf(buf + used, length - used, "inherited CPUs");
+    }
+    const char* policyName = "SCHED_OTHER";
+    switch (policy)
+    {
+    case SCHED_IDLE:
+        policyName = "SCHED_IDLE";
+        break;
+    case SCHED_BATCH:
+        policyName = "SCHED_BATCH";
+        break;
+    case SCHED_FIFO:
+        policyName = "SCHED_FIFO";
+        break;
+    case SCHED_RR:
+        policyName = "SCHED_RR";
+        break;
+    }
+    if (used < length)
+    {
+        used += snprintf(buf + used, length - used, ", %s", policyName);
+    }
+    if ((SCHED_FIFO == policy || SCHED_RR == policy) && used < length)
+    {
+        used += snprintf(buf + used, length - used, " priority %d", priority);
+    }
+    if (hasNice && used < length)
+    {
+        snprintf(buf + used, length - used, ", nice %d", niceValue);
+    }
+}
+
+int samplerplacement_set_attr(pthread_attr_t* attr)
+{
+    if (hasCpus && pthread_attr_setaffinity_np(attr, sizeof(cpu_set_t), &cpus))
+    {
+        return 1;
+    }
+    /* glibc only accepts the real-time policies in pthread attributes */
+    if (SCHED_FIFO == policy || SCHED_RR == policy)
+    {
+        struct sched_param param;
+        memset(&param, 0, sizeof(param));
+        param.sched_priority = priority;
+        if (pthread_attr_setinheritsched(attr, PTHREAD_EXPLICIT_SCHED) ||
+            pthread_attr_setschedpolicy(attr, policy) || pthread_attr_setschedparam(attr, &param))
+        {
+            return 2;
+        }
+    }
+    return 0;
+}
+
+void samplerplacement_describe_high_frequency(char* buf, size_t length)
+{
+    if (-1 != highFrequencyCpu)
+    {
+        snprintf(buf, length, "CPU %d", highFrequencyCpu);
+    }
+    else
+    {
+        snprintf(buf, length, "not pinned to a CPU of its own");
+    }
+}
+
+int samplerplacement_set_high_frequency_attr(pthread_attr_t* attr)
+{
+    if (-1 == highFrequencyCpu)
+    {
+        /* without a CPU of its own, the thread shares the CPUs of the sampler */
+        return (hasCpus && pthread_attr_setaffinity_np(attr, sizeof(cpu_set_t), &cpus)) ? 1 : 0;
+    }
+    cpu_set_t highFrequencyCpus;
+    CPU_ZERO(&highFrequencyCpus);
+    CPU_SET(highFrequencyCpu, &highFrequencyCpus);
+    return pthread_attr_setaffinity_np(attr, sizeof(cpu_set_t), &highFrequencyCpus) ? 1 : 0;
+}
+
+int samplerplacement_apply_to_self(void)
+{
+    if (SCHED_IDLE == policy || SCHED_BATCH == policy)
+    {
+        struct sched_param param;
+        memset(&param, 0, sizeof(param));
+        int result = pthread_setschedparam(pthread_self(), policy, &param);
+        if (result)
+        {
+            return result;
+        }
+    }
+    /* on Linux the nice value is an attribute of the thread */
+    if (hasNice && setpriority(PRIO_PROCESS, syscall(SYS_gettid), niceValue))
+    {
+        return errno;
+    }
+    return 0;
+}
@@ -0,0 +1,61 @@
+/*
+ * sampler_placement.h
+ *
+ *  Created on: 19.10.2026
+ */
+
+#ifndef SAMPLER_PLACEMENT_H_
+#define SAMPLER_PLACEMENT_H_
+
+/* required for pthread_attr_t */
+#include <pthread.h>
+/* required for size_t */
+#include <stddef.h>
+
+/**
+ * Reads where and with which scheduling parameters the sampler thread runs from the variables
+ * SCOREP_METRIC_FILEPARSER_PLUGIN_CPUS, _SCHED and _NICE. Without _CPUS, the sampler is pinned to
+ * the online CPUs which are neither isolated nor nohz_full, if the system has any such CPUs. The CPU
+ * of the high-frequency sampling thread is read from _HF_CPU.
+ *
+ * @return Returns 0 on success, a value greater than that if a variable could not be parsed, in
+ * which case the corresponding setting keeps its default
+ */
+int samplerplacement_read_env(void);
+
+/**
+ * Writes a human readable description of the placement, e.g. "CPUs 0-1, SCHED_IDLE", to buf
+ */
+void samplerplacement_describe(char* buf, size_t length);
+
+/**
+ * Sets the affinity and the real-time scheduling parameters of the placement in attr, which must
+ * have been initialized with pthread_attr_init
+ *
+ * @return Returns 0 on success, a value greater than that if attr rejected a parameter
+ */
+int samplerplacement_set_attr(pthread_attr_t* attr);
+
+/**
+ * Writes a human readable description of the placement of the high-frequency sampling thread, e.g.
+ * "CPU 7", to buf
+ */
+void samplerplacement_describe_high_frequency(char* buf, size_t length);
+
+/**
+ * Sets the affinity of the high-frequency sampling thread in attr: the CPU given for it, or the
+ * CPUs of the sampler if there is none. It keeps the default scheduling policy, as it spins.
+ *
+ * @return Returns 0 on success, a value greater than that if attr rejected the affinity
+ */
+int samplerplacement_set_high_frequency_attr(pthread_attr_t* attr);
+
+/**
+ * Sets SCHED_IDLE or SCHED_BATCH and the nice value of the calling thread, to be called by the
+ * sampler itself as pthread attributes carry neither of them
+ *
+ * @return Returns 0 on success or if there is nothing to set, a value greater than that on error
+ */
+int samplerplacement_apply_to_self(void);
+
+#endif /* SAMPLER_PLACEMENT_H_ */
@@ -0,0 +1,128 @@
+/*
+ * spill_file.c
+ *
+ *  Created on: 19.10.2026
+ */
+
+/* required for fallocate */
+#define _GNU_SOURCE
+
+#include "spill_file.h"
+
+/* required for errno, EINTR */
+#include <errno.h>
+/* required for fallocate, FALLOC_FL_PUNCH_HOLE */
+#include <fcntl.h>
+/* required for snprintf */
+#include <stdio.h>
+/* required for mkstemp */
+#include <stdlib.h>
+/* required for mmap, munmap */
+#include <sys/mman.h>
+/* required for pwrite, unlink, close, sysconf */
+#include <unistd.h>
+
+/** descriptor of the scratch file, -1 if it is not open */
+static int spillFd = -1;
+/** offset of the end of the scratch file, i.e. where the next bytes are appended */
+static uint64_t spillEnd = 0;
+
+int spillfile_open(const char* directory)
+{
+    if (-1 != spillFd)
+    {
+        return 0;
+    }
+    char path[4096];
+    if (sizeof(path) <= (size_t)snprintf(path, sizeof(path), "%s/scorep_fileparser_spill_XXXXXX",
+                                         directory))
+    {
+        return 1;
+    }
+    spillFd = mkstemp(path);
+    if (-1 == spillFd)
+    {
+        return 2;
+    }
+    /* nobody else needs to find the file, and it must not outlive a crashed process */
+    unlink(path);
+    spillEnd = 0;
+    return 0;
+}
+
+int spillfile_append(const void* data, size_t length, uint64_t* offset)
+{
+    if (-1 == spillFd)
+    {
+        return 1;
+    }
+    /* the bytes are placed atomically, as the high-frequency sampling thread spills as well. The
+     * bytes of a failed append are left as a hole. */
+    uint64_t appendOffset = __atomic_fetch_add(&spillEnd, length, __ATOMIC_RELAXED);
+    size_t written = 0;
+    while (written < length)
+    {
+        ssize_t writeReturn =
+            pwrite(spillFd, (const char*)data + written, length - written, appendOffset + written);
+        if (0 > writeReturn && EINTR == errno)
+        {
+            continue;
+        }
+        if (0 >= writeReturn)
+        {
+            spillfile_release(appendOffset, length);
+            return 2;
+        }
+        written += writeReturn;
+    }
+    *offset = appendOffset;
+    return 0;
+}
+
+const void* spillfile_map(uint64_t offset, size_t length, void** mapping, size_t* mappingLength)
+{
+    if (-1 == spillFd || 0 == length)
+    {
+        return NULL;
+    }
+    /* mappings have to begin at a page boundary */
+    uint64_t pageSize = sysconf(_SC_PAGESIZE);
+    uint64_t mappingOffset = offset - (offset % pageSize);
+    *mappingLength = length + (offset - mappingOffset);
+    *mapping = mmap(NULL, *mappingLength, PROT_READ, MAP_SHARED, spillFd, mappingOffset);
+    if (MAP_FAILED == *mapping)
+    {
+        *mapping = NULL;
+        return NULL;
+    }
+    /* the bytes are read once from front to back */
+    madvise(*mapping, *mappingLength, MADV_SEQUENTIAL);
+    return (const char*)*mapping + (offset - mappingOffset);
+}
+
+void spillfile_unmap(void* mapping, size_t mappingLength)
+{
+    if (NULL != mapping)
+    {
+        munmap(mapping, mappingLength);
+    }
+}
+
+void spillfile_release(uint64_t offset, size_t length)
+{
+    if (-1 != spillFd)
+    {
+        /* a file system that cannot punch holes keeps the bytes until the file is closed */
+        fallocate(spillFd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE, offset, length);
+    }
+}
+
+void spillfile_close(void)
+{
+    if (-1 != spillFd)
+    {
+        close(spillFd);
+        spillFd = -1;
+        spillEnd = 0;
+    }
+}
@@ -0,0 +1,57 @@
+/*
+ * spill_file.h
+ *
+ *  Created on: 19.10.2026
+ */
+
+#ifndef SPILL_FILE_H_
+#define SPILL_FILE_H_
+
+/* required for size_t */
+#include <stddef.h>
+/* required for uint64_t */
+#include <stdint.h>
+
+/**
+ * Creates the scratch file the logged values are spilled to once the memory budget is exceeded.
+ * The file is unlinked right away, so it vanishes with the process.
+ *
+ * @param directory where the file is created, usually the node-local $TMPDIR
+ * @return Returns 0 on success, a value greater than that if the file could not be created
+ */
+int spillfile_open(const char* directory);
+
+/**
+ * Appends length bytes to the end of the scratch file with as few writes as possible
+ *
+ * @param offset set to the offset within the file the bytes were written to
+ * @return Returns 0 on success, a value greater than that if the file is not open or the bytes
+ * could not be written, in which case nothing was appended
+ */
+int spillfile_append(const void* data, size_t length, uint64_t* offset);
+
+/**
+ * Maps length bytes of the scratch file beginning at offset for reading
+ *
+ * @param mapping set to the start of the mapping to be passed to spillfile_unmap
+ * @param mappingLength set to the length of the mapping to be passed to spillfile_unmap
+ * @return Returns the address of the byte at offset, NULL if the bytes could not be mapped
+ */
+const void* spillfile_map(uint64_t offset, size_t length, void** mapping, size_t* mappingLength);
+
+/**
+ * Unmaps bytes mapped by spillfile_map
+ */
+void spillfile_unmap(void* mapping, size_t mappingLength);
+
+/**
+ * Hands length bytes at offset, which were read back already, to the file system to be freed
+ */
+void spillfile_release(uint64_t offset, size_t length);
+
+/**
+ * Closes the scratch file, which frees all bytes spilled to it
+ */
+void spillfile_close(void);
+
+#endif /* SPILL_FILE_H_ */
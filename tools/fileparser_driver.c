@@ -0,0 +1,393 @@
+/*
+ * fileparser_driver.c
+ *
+ *  Created on: 19.10.2026
+ */
+
+/*
+ * Drives the plugin through its whole lifecycle the way Score-P does, without a measurement, and
+ * reports the plugin's overhead: the CPU time of its sampler thread, its RSS growth and the period
+ * it achieved together with its jitter.
+ *
+ * Usage: fileparser_driver [-l <plugin.so>] [-t <seconds>] [-g <get_all_values interval in ms>]
+ *                          [-f <clock ticks per second>] [-o <clock offset in ticks>] [<spec>]
+ *
+ * <spec> defaults to SCOREP_METRIC_FILEPARSER_PLUGIN, all other variables of the plugin are read
+ * by the plugin itself.
+ */
+
+/* required for dlopen, dlsym */
+#include <dlfcn.h>
+/* required for PRIu64 */
+#include <inttypes.h>
+/* required for sqrt */
+#include <math.h>
+/* required for pthread_self, pthread_getcpuclockid */
+#include <pthread.h>
+/* required for bool */
+#include <stdbool.h>
+/* required for printf, fopen */
+#include <stdio.h>
+/* required for malloc, getenv, strtod, qsort */
+#include <stdlib.h>
+/* required for strdup, strtok_r, strcmp */
+#include <string.h>
+/* required for prctl, PR_GET_NAME */
+#include <sys/prctl.h>
+/* required for clock_gettime */
+#include <time.h>
+/* required for getopt, usleep */
+#include <unistd.h>
+
+/* required for SCOREP_Metric_Plugin_Info */
+#include <scorep/SCOREP_MetricPlugins.h>
+
+#define DRIVER_MAX_CLOCK_CALLS (1 << 20)
+#define DRIVER_DEFAULT_PERIOD_USEC 100000
+/** the name the plugin gives its sampler thread */
+#define DRIVER_SAMPLER_THREAD_NAME "fileparser"
+
+/** monotonic times of the calls to the clock from the threads of the plugin, in ns */
+static uint64_t* clockCalls = NULL;
+/** count of claimed slots of clockCalls, may exceed DRIVER_MAX_CLOCK_CALLS */
+static uint64_t clockCallCount = 0;
+static uint64_t droppedClockCalls = 0;
+static pthread_t mainThread;
+static pthread_t samplerThread;
+static volatile int hasSamplerThread = 0;
+static double clockTicksPerNanosecond = 1.0;
+static uint64_t clockOffset = 0;
+
+static uint64_t monotonicNanoseconds(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+/**
+ * The fake clock handed to the plugin, records the calls of the threads of the plugin. The sampler,
+ * the deadline readers and the high-frequency thread call it concurrently, thus the slots are
+ * claimed atomically. The sampler is told apart from the other threads by the name the plugin gives
+ * it.
+ */
+static uint64_t fakeClock(void)
+{
+    uint64_t now = monotonicNanoseconds();
+    if (!pthread_equal(pthread_self(), mainThread))
+    {
+        char threadName[16] = "";
+        if (!__atomic_load_n(&hasSamplerThread, __ATOMIC_ACQUIRE) &&
+            0 == prctl(PR_GET_NAME, threadName) &&
+            0 == strcmp(threadName, DRIVER_SAMPLER_THREAD_NAME))
+        {
+            samplerThread = pthread_self();
+            __atomic_store_n(&hasSamplerThread, 1, __ATOMIC_RELEASE);
+        }
+        uint64_t slot = __atomic_fetch_add(&clockCallCount, 1, __ATOMIC_RELAXED);
+        if (slot < DRIVER_MAX_CLOCK_CALLS)
+        {
+            clockCalls[slot] = now;
+        }
+        else
+        {
+            __atomic_fetch_add(&droppedClockCalls, 1, __ATOMIC_RELAXED);
+        }
+    }
+    return clockOffset + (uint64_t)(now * clockTicksPerNanosecond);
+}
+
+static double threadCpuSeconds(clockid_t clockId)
+{
+    struct timespec cpuTime;
+    if (clock_gettime(clockId, &cpuTime))
+    {
+        return 0.0;
+    }
+    return cpuTime.tv_sec + cpuTime.tv_nsec / 1e9;
+}
+
+/**
+ * Returns the resident set size in KiB, or the peak resident set size if peak is set
+ */
+static uint64_t residentKibibytes(bool peak)
+{
+    const char* key = peak ? "VmHWM:" : "VmRSS:";
+    uint64_t kibibytes = 0;
+    char line[256];
+    FILE* status = fopen("/proc/self/status", "r");
+    if (NULL == status)
+    {
+        return 0;
+    }
+    while (NULL != fgets(line, sizeof(line), status))
+    {
+        if (0 == strncmp(line, key, strlen(key)))
+        {
+            kibibytes = strtoull(line + strlen(key), NULL, 10);
+            break;
+        }
+    }
+    fclose(status);
+    return kibibytes;
+}
+
+/**
+ * qsort comparator of uint64_t times
+ */
+static int compareTimes(const void* first, const void* second)
+{
+    uint64_t firstTime = *(const uint64_t*)first;
+    uint64_t secondTime = *(const uint64_t*)second;
+    return (firstTime > secondTime) - (firstTime < secondTime);
+}
+
+/**
+ * Groups the recorded clock calls into sampling cycles (calls less than half a period apart belong
+ * to the same cycle) and prints the period between the starts of consecutive cycles
+ */
+static void reportPeriod(uint64_t nominalPeriodNs)
+{
+    uint64_t recordedCalls =
+        (clockCallCount < DRIVER_MAX_CLOCK_CALLS) ? clockCallCount : DRIVER_MAX_CLOCK_CALLS;
+    /* calls of concurrent threads may have claimed their slots out of order */
+    qsort(clockCalls, recordedCalls, sizeof(uint64_t), compareTimes);
+    uint64_t cycleCount = 0, lastCycleStart = 0, previousCall = 0;
+    double sum = 0.0, sumSquares = 0.0, minPeriod = 0.0, maxPeriod = 0.0, maxDeviation = 0.0;
+    for (uint64_t i = 0; i < recordedCalls; ++i)
+    {
+        if (0 < i && clockCalls[i] - previousCall < nominalPeriodNs / 2)
+        {
+            previousCall = clockCalls[i];
+            continue;
+        }
+        previousCall = clockCalls[i];
+        if (0 < cycleCount)
+        {
+            double period = (clockCalls[i] - lastCycleStart) / 1e3;
+            sum += period;
+            sumSquares += period * period;
+            if (1 == cycleCount || period < minPeriod)
+            {
+                minPeriod = period;
+            }
+            if (1 == cycleCount || period > maxPeriod)
+            {
+                maxPeriod = period;
+            }
+            double deviation = fabs(period - nominalPeriodNs / 1e3);
+            if (deviation > maxDeviation)
+            {
+                maxDeviation = deviation;
+            }
+        }
+        lastCycleStart = clockCalls[i];
+        ++cycleCount;
+    }
+    printf("sampling cycles:        %" PRIu64 " (%" PRIu64 " clock calls, %" PRIu64
+           " not recorded)\n",
+           cycleCount, recordedCalls, droppedClockCalls);
+    if (1 < cycleCount)
+    {
+        double mean = sum / (cycleCount - 1);
+        double variance = sumSquares / (cycleCount - 1) - mean * mean;
+        printf("nominal period:         %.1f us\n", nominalPeriodNs / 1e3);
+        printf("achieved period:        %.1f us (min %.1f us, max %.1f us)\n", mean, minPeriod,
+               maxPeriod);
+        printf("jitter:                 %.1f us standard deviation, %.1f us max deviation\n",
+               sqrt(0.0 < variance ? variance : 0.0), maxDeviation);
+    }
+}
+
+static void printUsage(const char* program)
+{
+    fprintf(stderr,
+            "Usage: %s [-l <plugin.so>] [-t <seconds>] [-g <get_all_values interval in ms>]\n"
+            "       [-f <clock ticks per second>] [-o <clock offset in ticks>] [<spec>]\n",
+            program);
+}
+
+int main(int argc, char** argv)
+{
+    const char* pluginPath = "libfileparser_plugin.so";
+    double duration = 10.0;
+    double getAllValuesInterval = 1000.0;
+    int option;
+    while (-1 != (option = getopt(argc, argv, "l:t:g:f:o:h")))
+    {
+        switch (option)
+        {
+        case 'l':
+            pluginPath = optarg;
+            break;
+        case 't':
+            duration = strtod(optarg, NULL);
+            break;
+        case 'g':
+            getAllValuesInterval = strtod(optarg, NULL);
+            break;
+        case 'f':
+            clockTicksPerNanosecond = strtod(optarg, NULL) / 1e9;
+            break;
+        case 'o':
+            clockOffset = strtoull(optarg, NULL, 0);
+            break;
+        default:
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    const char* spec = (optind < argc) ? argv[optind] : getenv("SCOREP_METRIC_FILEPARSER_PLUGIN");
+    if (NULL == spec || 0.0 >= duration || 0.0 >= getAllValuesInterval ||
+        0.0 >= clockTicksPerNanosecond)
+    {
+        printUsage(argv[0]);
+        return 1;
+    }
+    uint64_t nominalPeriodNs = DRIVER_DEFAULT_PERIOD_USEC * 1000ull;
+    const char* periodFromEnv = getenv("SCOREP_METRIC_FILEPARSER_PLUGIN_PERIOD");
+    if (NULL != periodFromEnv && 0 < atoi(periodFromEnv))
+    {
+        nominalPeriodNs = atoi(periodFromEnv) * 1000ull;
+    }
+    mainThread = pthread_self();
+    clockCalls = malloc(DRIVER_MAX_CLOCK_CALLS * sizeof(uint64_t));
+    if (NULL == clockCalls)
+    {
+        fprintf(stderr, "Could not allocate memory for the clock calls.\n");
+        return 1;
+    }
+
+    uint64_t rssAtStart = residentKibibytes(false);
+    void* plugin = dlopen(pluginPath, RTLD_NOW | RTLD_LOCAL);
+    if (NULL == plugin)
+    {
+        fprintf(stderr, "Could not load the plugin: %s\n", dlerror());
+        return 1;
+    }
+    SCOREP_Metric_Plugin_Info (*getInfo)(void) = NULL;
+    /* ISO C does not allow casting the object pointer returned by dlsym to a function pointer */
+    *(void**)(&getInfo) = dlsym(plugin, "SCOREP_MetricPlugin_fileparser_plugin_get_info");
+    if (NULL == getInfo)
+    {
+        fprintf(stderr, "Could not find the plugin's entry function: %s\n", dlerror());
+        return 1;
+    }
+    SCOREP_Metric_Plugin_Info info = getInfo();
+    if (info.initialize())
+    {
+        fprintf(stderr, "Could not initialize the plugin.\n");
+        return 1;
+    }
+    info.set_clock_function(fakeClock);
+    uint64_t rssAfterLoad = residentKibibytes(false);
+
+    /* like Score-P, get the info on all variables of the spec first, then add their counters */
+    int reserve = 16, metricCount = 0, nameCount = 0;
+    char** names = malloc(reserve * sizeof(char*));
+    char* specDup = strdup(spec);
+    double registrationStart = monotonicNanoseconds() / 1e9;
+    char* savePtr = NULL;
+    for (char* variable = strtok_r(specDup, ",", &savePtr); NULL != variable;
+         variable = strtok_r(NULL, ",", &savePtr))
+    {
+        SCOREP_Metric_Plugin_MetricProperties* properties = info.get_event_info(variable);
+        for (int i = 0; NULL != properties && NULL != properties[i].name; ++i)
+        {
+            if (nameCount == reserve)
+            {
+                reserve *= 2;
+                names = realloc(names, reserve * sizeof(char*));
+            }
+            /* the plugin keeps track of the units itself */
+            names[nameCount++] = properties[i].name;
+        }
+        free(properties);
+    }
+    int32_t* ids = malloc(reserve * sizeof(int32_t));
+    for (int i = 0; i < nameCount; ++i)
+    {
+        int32_t id = info.add_counter(names[i]);
+        if (0 > id)
+        {
+            fprintf(stderr, "Could not add the counter \"%s\".\n", names[i]);
+        }
+        else
+        {
+            ids[metricCount++] = id;
+        }
+        free(names[i]);
+    }
+    free(names);
+    double registrationTime = monotonicNanoseconds() / 1e9 - registrationStart;
+    if (0 == metricCount)
+    {
+        fprintf(stderr, "No counter could be added.\n");
+        return 1;
+    }
+    uint64_t rssAfterRegistration = residentKibibytes(false);
+
+    /* let the sampler run, collecting its values periodically */
+    uint64_t rssPeak = rssAfterRegistration;
+    uint64_t totalValues = 0;
+    uint64_t runStart = monotonicNanoseconds();
+    uint64_t runEnd = runStart + (uint64_t)(duration * 1e9);
+    uint64_t now = runStart;
+    while (now < runEnd)
+    {
+        uint64_t wakeUp = now + (uint64_t)(getAllValuesInterval * 1e6);
+        usleep(((wakeUp < runEnd) ? wakeUp - now : runEnd - now) / 1000);
+        uint64_t rss = residentKibibytes(false);
+        if (rss > rssPeak)
+        {
+            rssPeak = rss;
+        }
+        for (int i = 0; i < metricCount; ++i)
+        {
+            SCOREP_MetricTimeValuePair* timeValueList = NULL;
+            uint64_t count = info.get_all_values(ids[i], &timeValueList);
+            totalValues += count;
+            free(timeValueList);
+        }
+        now = monotonicNanoseconds();
+    }
+    double elapsed = (now - runStart) / 1e9;
+    double samplerCpu = 0.0;
+    const char* samplerCpuSource = "sampler thread";
+    clockid_t samplerClock;
+    if (__atomic_load_n(&hasSamplerThread, __ATOMIC_ACQUIRE) &&
+        0 == pthread_getcpuclockid(samplerThread, &samplerClock))
+    {
+        samplerCpu = threadCpuSeconds(samplerClock);
+    }
+    else
+    {
+        /* the sampler thread was not seen, attribute all CPU time outside of main to it */
+        samplerCpu = threadCpuSeconds(CLOCK_PROCESS_CPUTIME_ID) -
+                     threadCpuSeconds(CLOCK_THREAD_CPUTIME_ID);
+        samplerCpuSource = "process minus main thread";
+    }
+    uint64_t rssAtEnd = residentKibibytes(false);
+    info.finalize();
+
+    printf("metrics:                %d\n", metricCount);
+    printf("registration time:      %.3f ms\n", registrationTime * 1e3);
+    printf("run time:               %.3f s\n", elapsed);
+    printf("sampler CPU time:       %.3f ms (%.3f%% of one CPU, %s)\n", samplerCpu * 1e3,
+           100.0 * samplerCpu / elapsed, samplerCpuSource);
+    printf("values collected:       %" PRIu64 "\n", totalValues);
+    reportPeriod(nominalPeriodNs);
+    printf("RSS at start:           %" PRIu64 " KiB\n", rssAtStart);
+    printf("RSS growth by loading:  %" PRId64 " KiB\n", (int64_t)(rssAfterLoad - rssAtStart));
+    printf("RSS growth by counters: %" PRId64 " KiB\n",
+           (int64_t)(rssAfterRegistration - rssAfterLoad));
+    printf("RSS growth by sampling: %" PRId64 " KiB (peak %" PRIu64 " KiB, high water mark %" PRIu64
+           " KiB)\n",
+           (int64_t)(rssAtEnd - rssAfterRegistration), rssPeak, residentKibibytes(true));
+
+    free(specDup);
+    free(ids);
+    free(clockCalls);
+    dlclose(plugin);
+    return 0;
+}
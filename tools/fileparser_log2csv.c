@@ -0,0 +1,183 @@
+/*
+ * fileparser_log2csv.c
+ *
+ *  Created on: 19.10.2026
+ */
+
+/*
+ * Converts a sample log written by the plugin (see SCOREP_METRIC_FILEPARSER_PLUGIN_LOG) to CSV,
+ * including logs of processes that were killed before their finalization.
+ *
+ * Usage: fileparser_log2csv <log>
+ *
+ * Prints one line per sample: its timestamp in ticks of the Score-P clock, its time of day in
+ * seconds since the epoch (empty if the rate of the clock was not known yet), the name and unit of
+ * its metric and its value.
+ */
+
+/* required for open */
+#include <fcntl.h>
+/* required for PRIu64, PRId64 */
+#include <inttypes.h>
+/* required for printf */
+#include <stdio.h>
+/* required for memcmp, memcpy */
+#include <string.h>
+/* required for mmap */
+#include <sys/mman.h>
+/* required for fstat */
+#include <sys/stat.h>
+/* required for close */
+#include <unistd.h>
+
+/* required for SCOREP_MetricValueType */
+#include <scorep/SCOREP_MetricPlugins.h>
+
+/* required for struct sample_log_header */
+#include "../sample_log.h"
+
+/**
+ * Prints a field of CSV, quoted if it contains a separator, a quote or a line break
+ */
+static void printField(const char* field, size_t maxLength)
+{
+    size_t length = strnlen(field, maxLength);
+    if (length == strcspn(field, ",\"\n\r"))
+    {
+        fwrite(field, 1, length, stdout);
+        return;
+    }
+    putchar('"');
+    for (size_t i = 0; i < length; ++i)
+    {
+        if ('"' == field[i])
+        {
+            putchar('"');
+        }
+        putchar(field[i]);
+    }
+    putchar('"');
+}
+
+static void printValue(uint64_t value, uint32_t datatype)
+{
+    union {
+        double dbl;
+        uint64_t uint;
+        int64_t sint;
+    } u_value;
+    u_value.uint = value;
+    switch (datatype)
+    {
+    case SCOREP_METRIC_VALUE_UINT64:
+        printf("%" PRIu64, u_value.uint);
+        break;
+    case SCOREP_METRIC_VALUE_DOUBLE:
+        printf("%.17g", u_value.dbl);
+        break;
+    case SCOREP_METRIC_VALUE_INT64: /* fall-through */
+    default:
+        printf("%" PRId64, u_value.sint);
+        break;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (2 != argc)
+    {
+        fprintf(stderr, "Usage: %s <log>\n", argv[0]);
+        return 1;
+    }
+    int fd = open(argv[1], O_RDONLY);
+    struct stat logStat;
+    if (-1 == fd || fstat(fd, &logStat))
+    {
+        perror(argv[1]);
+        return 1;
+    }
+    uint64_t fileSize = logStat.st_size;
+    if (fileSize < sizeof(struct sample_log_header))
+    {
+        fprintf(stderr, "%s: too short to be a sample log\n", argv[1]);
+        return 1;
+    }
+    const char* mapping = mmap(NULL, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (MAP_FAILED == mapping)
+    {
+        perror(argv[1]);
+        return 1;
+    }
+    struct sample_log_header header;
+    memcpy(&header, mapping, sizeof(header));
+    if (memcmp(header.magic, SAMPLE_LOG_MAGIC, sizeof(header.magic)) ||
+        SAMPLE_LOG_VERSION != header.version || sizeof(header) != header.headerSize ||
+        sizeof(struct sample_log_metric) != header.metricSize ||
+        sizeof(struct sample_log_record) != header.recordSize ||
+        header.metricTableOffset + header.metricCapacity * header.metricSize > fileSize ||
+        header.recordOffset > fileSize)
+    {
+        fprintf(stderr, "%s: not a sample log of version %d\n", argv[1], SAMPLE_LOG_VERSION);
+        return 1;
+    }
+    const struct sample_log_metric* metrics =
+        (const struct sample_log_metric*)(mapping + header.metricTableOffset);
+    const struct sample_log_record* records =
+        (const struct sample_log_record*)(mapping + header.recordOffset);
+    uint64_t recordCount = (fileSize - header.recordOffset) / header.recordSize;
+    if (recordCount > header.recordCapacity)
+    {
+        recordCount = header.recordCapacity;
+    }
+
+    printf("timestamp,time,metric,unit,value\n");
+    uint64_t printed = 0;
+    uint64_t unknown = 0;
+    /* the records behind recordCount of the header were written after the latest sampling cycle,
+     * they are valid until the first one that was never written */
+    for (uint64_t i = 0; i < recordCount; ++i)
+    {
+        const struct sample_log_record* record = records + i;
+        if (0 == record->metric)
+        {
+            if (i >= header.recordCount)
+            {
+                break;
+            }
+            continue;
+        }
+        if (record->metric > header.metricCapacity || !metrics[record->metric - 1].used)
+        {
+            ++unknown;
+            continue;
+        }
+        const struct sample_log_metric* metric = metrics + record->metric - 1;
+        printf("%" PRIu64 ",", record->timestamp);
+        if (0 < header.ticksPerSecond)
+        {
+            double offset = ((double)record->timestamp - (double)header.anchorTicks) /
+                            header.ticksPerSecond;
+            printf("%.9f", header.anchorRealtime / 1e9 + offset);
+        }
+        putchar(',');
+        printField(metric->name, sizeof(metric->name));
+        putchar(',');
+        printField(metric->unit, sizeof(metric->unit));
+        putchar(',');
+        printValue(record->value, metric->datatype);
+        putchar('\n');
+        ++printed;
+    }
+    fprintf(stderr, "%" PRIu64 " samples", printed);
+    if (0 < unknown)
+    {
+        fprintf(stderr, ", %" PRIu64 " of unknown metrics skipped", unknown);
+    }
+    if (0 < header.droppedRecords)
+    {
+        fprintf(stderr, ", %" PRIu64 " did not fit into the log", header.droppedRecords);
+    }
+    fprintf(stderr, "\n");
+    return 0;
+}
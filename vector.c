@@ -71,6 +71,25 @@ int vec_append(struct Vector* container, void* value)
     return 0;
 }
 
+int vec_reserve(struct Vector* container, int capacity)
+{
+    if (NULL == container)
+    {
+        return 1;
+    }
+    if (capacity > container->reserve)
+    {
+        void** reallocArr = realloc(container->data, capacity * sizeof(void*));
+        if (NULL == reallocArr)
+        {
+            return 2;
+        }
+        container->reserve = capacity;
+        container->data = reallocArr;
+    }
+    return 0;
+}
+
 void vec_destroy(struct Vector* container)
 {
     if (NULL == container)
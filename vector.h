@@ -35,6 +35,13 @@ struct Vector* vec_create(int initialCapacity);
  */
 int vec_append(struct Vector* container, void* value);
 
+/**
+ * Makes sure a struct Vector can hold at least capacity elements without further allocations
+ *
+ * @return Returns 0 on success, a value greater than that on error
+ */
+int vec_reserve(struct Vector* container, int capacity);
+
 /**
  * Destroys a given vector, i.e. doing a free on it's data and on the vector itself
  */